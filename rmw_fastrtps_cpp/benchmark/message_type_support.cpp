@@ -0,0 +1,46 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <memory>
+
+#include "rosidl_typesupport_fastrtps_c/identifier.h"
+#include "rosidl_typesupport_fastrtps_cpp/identifier.hpp"
+#include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
+
+#include "rmw_fastrtps_cpp/MessageTypeSupport.hpp"
+
+#include "message_type_support.hpp"
+
+namespace benchmark
+{
+
+std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>
+create_message_type_support(const rosidl_message_type_support_t * type_support)
+{
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_fastrtps_c__identifier);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, rosidl_typesupport_fastrtps_cpp::typesupport_identifier);
+    if (!ts) {
+      return nullptr;
+    }
+  }
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
+  return std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>(
+    new rmw_fastrtps_cpp::MessageTypeSupport(callbacks));
+}
+
+}  // namespace benchmark
@@ -0,0 +1,72 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_CPP__BACKLOG_WATERMARKS_HPP_
+#define RMW_FASTRTPS_CPP__BACKLOG_WATERMARKS_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_cpp
+{
+
+/// Trigger guard conditions when the backlog of a subscription crosses watermarks.
+/**
+ * The backlog is the number of received samples not taken yet. The high guard
+ * condition is triggered when it grows up to `high_watermark`, and the low one
+ * when it then shrinks back down to `low_watermark`, waking up any wait set
+ * they are attached to. Either guard condition may be `NULL`.
+ * The guard conditions must outlive the subscription, or the watermarks be
+ * disabled first.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[in] high_watermark backlog raising the high event, zero to disable the watermarks
+ * \param[in] low_watermark backlog raising the low event, lower than `high_watermark`
+ * \param[in] high_guard_condition guard condition triggered on the high watermark
+ * \param[in] low_guard_condition guard condition triggered on the low watermark
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+set_subscription_backlog_watermarks(
+  const rmw_subscription_t * subscription,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition);
+
+/// Trigger guard conditions when the backlog of a service crosses watermarks.
+/**
+ * The backlog is the number of received requests not taken yet, with the
+ * same semantics as `set_subscription_backlog_watermarks()`.
+ *
+ * \param[in] service service handle from this rmw implementation
+ * \param[in] high_watermark backlog raising the high event, zero to disable the watermarks
+ * \param[in] low_watermark backlog raising the low event, lower than `high_watermark`
+ * \param[in] high_guard_condition guard condition triggered on the high watermark
+ * \param[in] low_guard_condition guard condition triggered on the low watermark
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+set_service_backlog_watermarks(
+  const rmw_service_t * service,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition);
+
+}  // namespace rmw_fastrtps_cpp
+
+#endif  // RMW_FASTRTPS_CPP__BACKLOG_WATERMARKS_HPP_
@@ -0,0 +1,49 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_cpp/backlog_watermarks.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+set_subscription_backlog_watermarks(
+  const rmw_subscription_t * subscription,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_set_subscription_backlog_watermarks(
+    eprosima_fastrtps_identifier, subscription, high_watermark, low_watermark,
+    high_guard_condition, low_guard_condition);
+}
+
+rmw_ret_t
+set_service_backlog_watermarks(
+  const rmw_service_t * service,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_set_service_backlog_watermarks(
+    eprosima_fastrtps_identifier, service, high_watermark, low_watermark,
+    high_guard_condition, low_guard_condition);
+}
+
+}  // namespace rmw_fastrtps_cpp
@@ -0,0 +1,67 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_cpp/memory_footprint.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+get_publisher_memory_footprint(const rmw_publisher_t * publisher, MemoryFootprint * footprint)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_publisher_memory_footprint(
+    eprosima_fastrtps_identifier, publisher, footprint);
+}
+
+rmw_ret_t
+get_subscription_memory_footprint(
+  const rmw_subscription_t * subscription, MemoryFootprint * footprint)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_memory_footprint(
+    eprosima_fastrtps_identifier, subscription, footprint);
+}
+
+rmw_ret_t
+get_service_memory_footprint(const rmw_service_t * service, MemoryFootprint * footprint)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_service_memory_footprint(
+    eprosima_fastrtps_identifier, service, footprint);
+}
+
+rmw_ret_t
+get_client_memory_footprint(const rmw_client_t * client, MemoryFootprint * footprint)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_client_memory_footprint(
+    eprosima_fastrtps_identifier, client, footprint);
+}
+
+rmw_ret_t
+get_node_memory_footprint(const rmw_node_t * node, MemoryFootprint * footprint)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_node_memory_footprint(
+    eprosima_fastrtps_identifier, node, footprint);
+}
+
+rmw_ret_t
+get_node_peer_memory_footprints(
+  const rmw_node_t * node, PeerMemoryFootprint * footprints, size_t capacity, size_t * count)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_node_peer_memory_footprints(
+    eprosima_fastrtps_identifier, node, footprints, capacity, count);
+}
+
+}  // namespace rmw_fastrtps_cpp
@@ -21,6 +21,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/endpoint_attributes.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
@@ -123,8 +124,7 @@ rmw_create_client(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    subscriberParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    subscriberParam.times = impl->reader_times;
   }
 
   subscriberParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -137,9 +137,11 @@ rmw_create_client(
   subscriberParam.topic.topicName += "Reply";
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-    publisherParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(
+      impl->publishing_mode,
+      rmw_fastrtps_shared_cpp::is_high_priority_topic(impl, service_name),
+      info->request_type_support_);
+    publisherParam.times = impl->writer_times;
   }
 
   publisherParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -167,19 +169,37 @@ rmw_create_client(
     RMW_SET_ERROR_MSG("failed to get datareader qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, subscriberParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->response_type_support_,
+      subscriberParam.topic, subscriberParam.historyMemoryPolicy);
+  }
   info->listener_ = new ClientListener(info);
+  if (impl->zero_allocation) {
+    info->listener_->preallocate(
+      static_cast<size_t>(rmw_fastrtps_shared_cpp::get_history_samples(subscriberParam.topic)),
+      info->response_type_support_->m_typeSize);
+  }
   info->response_subscriber_ =
     Domain::createSubscriber(participant, subscriberParam, info->listener_);
   if (!info->response_subscriber_) {
     RMW_SET_ERROR_MSG("create_client() could not create subscriber");
     goto fail;
   }
+  info->preallocated_history_size_ = rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->response_type_support_, subscriberParam.topic, subscriberParam.historyMemoryPolicy);
 
   // Create Client Subscriber and set QoS
   if (!get_datawriter_qos(*qos_policies, publisherParam)) {
     RMW_SET_ERROR_MSG("failed to get datawriter qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, publisherParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->request_type_support_, publisherParam.topic, publisherParam.historyMemoryPolicy);
+  }
   info->pub_listener_ = new ClientPubListener(info);
   info->request_publisher_ =
     Domain::createPublisher(participant, publisherParam, info->pub_listener_);
@@ -187,6 +207,8 @@ rmw_create_client(
     RMW_SET_ERROR_MSG("create_publisher() could not create publisher");
     goto fail;
   }
+  info->preallocated_history_size_ += rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->request_type_support_, publisherParam.topic, publisherParam.historyMemoryPolicy);
 
   info->writer_guid_ = info->request_publisher_->getGuid();
 
@@ -206,6 +228,8 @@ rmw_create_client(
   }
   memcpy(const_cast<char *>(rmw_client->service_name), service_name, strlen(service_name) + 1);
 
+  impl->entity_counters.add(&info->counters_);
+  rmw_fastrtps_shared_cpp::export_client_statistics(node, info, service_name);
   return rmw_client;
 
 fail:
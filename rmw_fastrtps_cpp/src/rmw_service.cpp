@@ -32,6 +32,7 @@
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/endpoint_attributes.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 
@@ -73,7 +74,7 @@ rmw_create_service(
     return nullptr;
   }
 
-  const CustomParticipantInfo * impl = static_cast<CustomParticipantInfo *>(node->data);
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
   if (!impl) {
     RMW_SET_ERROR_MSG("node impl is null");
     return nullptr;
@@ -133,8 +134,7 @@ rmw_create_service(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    subscriberParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    subscriberParam.times = impl->reader_times;
   }
 
   subscriberParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -147,9 +147,11 @@ rmw_create_service(
   subscriberParam.topic.topicName += "Request";
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-    publisherParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(
+      impl->publishing_mode,
+      rmw_fastrtps_shared_cpp::is_high_priority_topic(impl, service_name),
+      info->response_type_support_);
+    publisherParam.times = impl->writer_times;
   }
 
   publisherParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -177,25 +179,46 @@ rmw_create_service(
     RMW_SET_ERROR_MSG("failed to get datareader qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, subscriberParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->request_type_support_,
+      subscriberParam.topic, subscriberParam.historyMemoryPolicy);
+  }
   info->listener_ = new ServiceListener(info);
+  if (impl->zero_allocation) {
+    info->listener_->preallocate(
+      static_cast<size_t>(rmw_fastrtps_shared_cpp::get_history_samples(subscriberParam.topic)),
+      info->request_type_support_->m_typeSize);
+  }
   info->request_subscriber_ =
     Domain::createSubscriber(participant, subscriberParam, info->listener_);
   if (!info->request_subscriber_) {
     RMW_SET_ERROR_MSG("create_client() could not create subscriber");
     goto fail;
   }
+  info->preallocated_history_size_ = rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->request_type_support_, subscriberParam.topic, subscriberParam.historyMemoryPolicy);
 
   // Create Service Publisher and set QoS
   if (!get_datawriter_qos(*qos_policies, publisherParam)) {
     RMW_SET_ERROR_MSG("failed to get datawriter qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, publisherParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->response_type_support_,
+      publisherParam.topic, publisherParam.historyMemoryPolicy);
+  }
   info->response_publisher_ =
     Domain::createPublisher(participant, publisherParam, nullptr);
   if (!info->response_publisher_) {
     RMW_SET_ERROR_MSG("create_publisher() could not create publisher");
     goto fail;
   }
+  info->preallocated_history_size_ += rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->response_type_support_, publisherParam.topic, publisherParam.historyMemoryPolicy);
 
   rmw_service = rmw_service_allocate();
   if (!rmw_service) {
@@ -212,6 +235,8 @@ rmw_create_service(
   }
   memcpy(const_cast<char *>(rmw_service->service_name), service_name, strlen(service_name) + 1);
 
+  impl->entity_counters.add(&info->counters_);
+  rmw_fastrtps_shared_cpp::export_service_statistics(node, info, service_name);
   return rmw_service;
 
 fail:
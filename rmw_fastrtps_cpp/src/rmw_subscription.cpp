@@ -21,8 +21,10 @@
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/endpoint_attributes.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
 
 #include "fastrtps/participant/Participant.h"
 #include "fastrtps/subscriber/Subscriber.h"
@@ -117,8 +119,17 @@ rmw_create_subscription(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    subscriberParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    subscriberParam.times = impl->reader_times;
+    auto separation = impl->minimum_separations.find(topic_name);
+    if (separation != impl->minimum_separations.end()) {
+      // announced to the writers, and enforced when taking
+      subscriberParam.qos.m_timeBasedFilter.minimum_separation = separation->second;
+    }
+    auto age = impl->max_sample_ages.find(topic_name);
+    if (age != impl->max_sample_ages.end()) {
+      // enforced when taking
+      info->max_sample_age_ns_ = rmw_fastrtps_shared_cpp::time_to_nanoseconds(age->second);
+    }
   }
 
   subscriberParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -133,18 +144,54 @@ rmw_create_subscription(
     RMW_SET_ERROR_MSG("failed to get datareader qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    if (impl->mailbox_topics.find(topic_name) != impl->mailbox_topics.end()) {
+      // the mailbox takes every sample as soon as it arrives
+      subscriberParam.topic.historyQos.kind = eprosima::fastrtps::KEEP_LAST_HISTORY_QOS;
+      subscriberParam.topic.historyQos.depth = 1;
+      info->mailbox_.reset(new (std::nothrow) SubscriberMailbox());
+      if (!info->mailbox_) {
+        RMW_SET_ERROR_MSG("failed to allocate SubscriberMailbox");
+        goto fail;
+      }
+      // preallocated for the largest sample of bounded types
+      info->mailbox_->buffer_.reserve(info->type_support_->m_typeSize);
+    }
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, subscriberParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->type_support_, subscriberParam.topic, subscriberParam.historyMemoryPolicy);
+  }
+
+  if (impl->zero_allocation) {
+    // serialized takes overwrite a single buffer rather than allocating one per sample
+    info->take_buffer_.reset(new (std::nothrow) eprosima::fastcdr::FastBuffer());
+    if (!info->take_buffer_) {
+      RMW_SET_ERROR_MSG("failed to allocate take buffer");
+      goto fail;
+    }
+    info->take_buffer_->reserve(info->type_support_->m_typeSize);
+  }
+
+  info->minimum_separation_ns_ = rmw_fastrtps_shared_cpp::time_to_nanoseconds(
+    subscriberParam.qos.m_timeBasedFilter.minimum_separation);
 
   info->listener_ = new (std::nothrow) SubListener(info);
   if (!info->listener_) {
     RMW_SET_ERROR_MSG("create_subscriber() could not create subscriber listener");
     goto fail;
   }
+  if (impl->zero_allocation) {
+    info->listener_->preallocate(
+      static_cast<size_t>(rmw_fastrtps_shared_cpp::get_history_samples(subscriberParam.topic)));
+  }
 
   info->subscriber_ = Domain::createSubscriber(participant, subscriberParam, info->listener_);
   if (!info->subscriber_) {
     RMW_SET_ERROR_MSG("create_subscriber() could not create subscriber");
     goto fail;
   }
+  info->preallocated_history_size_ = rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->type_support_, subscriberParam.topic, subscriberParam.historyMemoryPolicy);
 
   rmw_subscription = rmw_subscription_allocate();
   if (!rmw_subscription) {
@@ -162,6 +209,8 @@ rmw_create_subscription(
   }
 
   memcpy(const_cast<char *>(rmw_subscription->topic_name), topic_name, strlen(topic_name) + 1);
+  impl->entity_counters.add(&info->counters_);
+  rmw_fastrtps_shared_cpp::export_subscription_statistics(node, info, topic_name);
   return rmw_subscription;
 
 fail:
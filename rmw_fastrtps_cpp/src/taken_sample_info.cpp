@@ -0,0 +1,45 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_cpp/taken_sample_info.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+get_subscription_taken_sample_info(
+  const rmw_subscription_t * subscription, TakenSampleInfo * sample_info)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_taken_sample_info(
+    eprosima_fastrtps_identifier, subscription, sample_info);
+}
+
+rmw_ret_t
+get_service_taken_request_info(const rmw_service_t * service, TakenSampleInfo * sample_info)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_service_taken_request_info(
+    eprosima_fastrtps_identifier, service, sample_info);
+}
+
+rmw_ret_t
+get_client_taken_response_info(const rmw_client_t * client, TakenSampleInfo * sample_info)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_client_taken_response_info(
+    eprosima_fastrtps_identifier, client, sample_info);
+}
+
+}  // namespace rmw_fastrtps_cpp
@@ -0,0 +1,54 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <memory>
+
+#include "rosidl_typesupport_introspection_c/identifier.h"
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+#include "rosidl_typesupport_introspection_cpp/identifier.hpp"
+#include "rosidl_typesupport_introspection_cpp/message_introspection.hpp"
+
+#include "rmw_fastrtps_dynamic_cpp/MessageTypeSupport.hpp"
+
+#include "message_type_support.hpp"
+
+namespace benchmark
+{
+
+std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>
+create_message_type_support(const rosidl_message_type_support_t * type_support)
+{
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (ts) {
+    auto members = static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+      ts->data);
+    return std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>(
+      new rmw_fastrtps_dynamic_cpp::MessageTypeSupport<
+        rosidl_typesupport_introspection_c__MessageMembers>(members));
+  }
+  ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  if (ts) {
+    auto members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+      ts->data);
+    return std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>(
+      new rmw_fastrtps_dynamic_cpp::MessageTypeSupport<
+        rosidl_typesupport_introspection_cpp::MessageMembers>(members));
+  }
+  return nullptr;
+}
+
+}  // namespace benchmark
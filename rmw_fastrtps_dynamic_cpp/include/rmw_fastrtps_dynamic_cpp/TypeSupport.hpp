@@ -140,6 +140,11 @@ public:
 
   bool deserializeROSmessage(eprosima::fastcdr::Cdr & deser, void * ros_message);
 
+  const MembersType * members() const
+  {
+    return members_;
+  }
+
 protected:
   TypeSupport();
 
@@ -0,0 +1,78 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__CONTENT_FILTER_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__CONTENT_FILTER_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw/types.h"
+#include "rosidl_generator_c/message_type_support_struct.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Only take the samples of a subscription whose fields match an expression.
+/**
+ * The expression is a conjunction of comparisons between a field and a literal:
+ *
+ *     class_id == 3 AND header.frame_id != 'map' AND score >= 0.5
+ *
+ * Fields are named by their path from the message root, through nested
+ * messages. Only fields of primitive or string types which are not arrays
+ * can be compared. Numeric and boolean fields support the `==`, `!=`, `<`,
+ * `<=`, `>` and `>=` operators against number or `true` / `false` literals,
+ * and string fields support them against quoted literals.
+ *
+ * The expression is evaluated on the serialized sample, reading only the
+ * fields up to the last one compared, so samples which do not match are
+ * discarded when taking without ever being deserialized.
+ *
+ * It may be called while other threads take from the subscription: each take uses
+ * either the previous filter or the new one.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[in] filter_expression expression to match, or `NULL` or an empty
+ *   string to take every sample again
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`, which is also returned
+ *   when the expression is malformed, names a field the type does not have, or needs
+ *   to read members of types the filter cannot read
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+set_subscription_content_filter(
+  const rmw_subscription_t * subscription, const char * filter_expression);
+
+/// Evaluate a content filter expression on a serialized sample.
+/**
+ * The expression is parsed and evaluated as set_subscription_content_filter()
+ * would, so that it can be checked against samples without a subscription.
+ *
+ * \param[in] type_support type support of the message, with an introspection type support
+ * \param[in] filter_expression expression to match, or `NULL` or an empty string
+ *   to match every sample
+ * \param[in] serialized_message sample, as serialized by rmw_serialize()
+ * \param[out] matches whether the sample would be taken
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`, which is also returned
+ *   for the expressions set_subscription_content_filter() rejects
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+evaluate_content_filter(
+  const rosidl_message_type_support_t * type_support, const char * filter_expression,
+  const rmw_serialized_message_t * serialized_message, bool * matches);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__CONTENT_FILTER_HPP_
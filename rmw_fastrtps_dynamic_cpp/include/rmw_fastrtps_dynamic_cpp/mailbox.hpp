@@ -0,0 +1,49 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__MAILBOX_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__MAILBOX_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Read the latest sample of a mailbox subscription without removing it.
+/**
+ * The subscriptions of the topics listed in the RMW_FASTRTPS_MAILBOX_TOPICS
+ * env variable only keep the latest sample received, overwriting the previous
+ * one. Taking from them removes that sample, while reading it leaves it
+ * available to further reads and takes until a newer sample replaces it.
+ *
+ * Either way, the subscription is only ready again once a new sample arrives.
+ *
+ * \param[in] subscription mailbox subscription handle from this rmw implementation
+ * \param[out] ros_message message the latest sample is deserialized into
+ * \param[out] taken whether there was a sample to read
+ * \param[out] message_info information about the sample, may be `NULL`
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+read_latest_message(
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__MAILBOX_HPP_
@@ -0,0 +1,115 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__MEMORY_FOOTPRINT_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__MEMORY_FOOTPRINT_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+using MemoryFootprint = rmw_fastrtps_shared_cpp::MemoryFootprint;
+using PeerMemoryFootprint = rmw_fastrtps_shared_cpp::PeerMemoryFootprint;
+
+/// Return the estimated memory held by a publisher.
+/**
+ * The estimate covers the structures rmw_fastrtps allocates for the publisher, the
+ * set of its matched subscriptions and the payloads its history preallocated from its
+ * memory policy. Allocator overhead and the internals of Fast RTPS are not included,
+ * so that the figures are lower bounds of the resident memory, with the error bounds
+ * given by `rmw_fastrtps_shared_cpp::MemoryFootprint`.
+ *
+ * \param[in] publisher publisher handle from this rmw implementation
+ * \param[out] footprint estimated entity and history bytes
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_publisher_memory_footprint(const rmw_publisher_t * publisher, MemoryFootprint * footprint);
+
+/// Return the estimated memory held by a subscription.
+/**
+ * Besides the estimate of `get_publisher_memory_footprint()`, it covers the mailbox,
+ * the take buffer, the ring of reception times of unread samples and the sequence numbers
+ * tracked per matched writer.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] footprint estimated entity and history bytes
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_memory_footprint(
+  const rmw_subscription_t * subscription, MemoryFootprint * footprint);
+
+/// Return the estimated memory held by a service.
+/**
+ * The estimate covers both endpoints, the queued requests and the pooled buffers.
+ *
+ * \param[in] service service handle from this rmw implementation
+ * \param[out] footprint estimated entity and history bytes
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_service_memory_footprint(const rmw_service_t * service, MemoryFootprint * footprint);
+
+/// Return the estimated memory held by a client.
+/**
+ * The estimate covers both endpoints, the queued responses and the pooled buffers.
+ *
+ * \param[in] client client handle from this rmw implementation
+ * \param[out] footprint estimated entity and history bytes
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_client_memory_footprint(const rmw_client_t * client, MemoryFootprint * footprint);
+
+/// Return the estimated memory held by a node, besides its entities.
+/**
+ * The entity bytes are those of the node and of its configuration, while the discovery
+ * bytes are those of the names and topic caches of the discovered participants.
+ * The footprint of the whole node is this one summed with those of its entities.
+ *
+ * \param[in] node node handle from this rmw implementation
+ * \param[out] footprint estimated entity and discovery bytes
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_node_memory_footprint(const rmw_node_t * node, MemoryFootprint * footprint);
+
+/// Return the estimated memory held by a node for each participant it discovered.
+/**
+ * Only the first `capacity` participants are copied, while `count` is set to the
+ * number of discovered participants, so that a larger array can be given when needed.
+ *
+ * \param[in] node node handle from this rmw implementation
+ * \param[out] footprints array of `capacity` footprints, ordered by GUID
+ * \param[in] capacity size of the footprints array, may be zero
+ * \param[out] count number of participants discovered by the node
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_node_peer_memory_footprints(
+  const rmw_node_t * node, PeerMemoryFootprint * footprints, size_t capacity, size_t * count);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__MEMORY_FOOTPRINT_HPP_
@@ -0,0 +1,286 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__STATISTICS_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__STATISTICS_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_shared_cpp/discovery_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/latency_histogram.hpp"
+#include "rmw_fastrtps_shared_cpp/rate_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/sample_loss.hpp"
+#include "rmw_fastrtps_shared_cpp/wait_set_counters.hpp"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+using DiscoveryStatistics = rmw_fastrtps_shared_cpp::DiscoveryStatistics;
+using EntityStatistics = rmw_fastrtps_shared_cpp::EntityStatistics;
+using LatencyHistogram = rmw_fastrtps_shared_cpp::LatencyHistogram;
+using RateStatistics = rmw_fastrtps_shared_cpp::RateStatistics;
+using SampleLossStatistics = rmw_fastrtps_shared_cpp::SampleLossStatistics;
+using WaitSetStatistics = rmw_fastrtps_shared_cpp::WaitSetStatistics;
+
+/// Return the number of samples a publisher could not add to its full history.
+/**
+ * Only publishers with a KEEP_ALL history overflow, once their resource
+ * limits are reached by samples not yet acknowledged by every subscription.
+ *
+ * \param[in] publisher publisher handle from this rmw implementation
+ * \param[out] count number of samples rejected since the publisher was created
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_publisher_history_overflow_count(const rmw_publisher_t * publisher, uint64_t * count);
+
+/// Return the number of times the history of a subscription became full.
+/**
+ * Only subscriptions with a KEEP_ALL history overflow, once their resource
+ * limits are reached by samples which have not been taken yet.
+ * Further samples are rejected until some are taken. Each time counts once,
+ * however many samples are then rejected, as Fast RTPS does not report them.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] count number of times the history became full
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_history_overflow_count(
+  const rmw_subscription_t * subscription, uint64_t * count);
+
+/// Return the number of samples a subscription discarded for being too old.
+/**
+ * Only the subscriptions of the topics given a maximum sample age in the
+ * RMW_FASTRTPS_MAX_SAMPLE_AGE_MS env variable discard samples, when they are
+ * taken later than that age after their source timestamp.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] count number of samples discarded since the subscription was created
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_expired_sample_count(
+  const rmw_subscription_t * subscription, uint64_t * count);
+
+/// Return a snapshot of the counters of a publisher.
+/**
+ * The counters are updated with relaxed atomic operations whenever a message
+ * is published, so the snapshot is not taken at a single instant.
+ *
+ * \param[in] publisher publisher handle from this rmw implementation
+ * \param[out] statistics messages and bytes sent and time spent serializing them
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_publisher_statistics(const rmw_publisher_t * publisher, EntityStatistics * statistics);
+
+/// Return a snapshot of the counters of a subscription.
+/**
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] statistics messages and bytes taken, time spent deserializing them,
+ *   takes which found nothing, and current and peak number of samples not taken yet
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_statistics(
+  const rmw_subscription_t * subscription, EntityStatistics * statistics);
+
+/// Return a snapshot of the counters of a service.
+/**
+ * \param[in] service service handle from this rmw implementation
+ * \param[out] statistics requests taken and responses sent
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_service_statistics(const rmw_service_t * service, EntityStatistics * statistics);
+
+/// Return a snapshot of the counters of a client.
+/**
+ * \param[in] client client handle from this rmw implementation
+ * \param[out] statistics requests sent and responses taken
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_client_statistics(const rmw_client_t * client, EntityStatistics * statistics);
+
+/// Return the sum of the counters of every entity currently created on a node.
+/**
+ * \param[in] node node handle from this rmw implementation
+ * \param[out] statistics sum of the counters, including the current and peak backlogs
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_node_statistics(const rmw_node_t * node, EntityStatistics * statistics);
+
+/// Return the discovery activity of the participant of a node.
+/**
+ * Discovery has converged once the number of discovered endpoints stops growing
+ * and the last change time of the topic caches is old enough.
+ *
+ * \param[in] node node handle from this rmw implementation
+ * \param[out] statistics discovered and removed participants and endpoints,
+ *   graph guard condition triggers and time spent in the discovery callbacks
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_node_discovery_statistics(const rmw_node_t * node, DiscoveryStatistics * statistics);
+
+/// Return the counters of the calls to rmw_wait on a wait set.
+/**
+ * \param[in] wait_set wait set handle from this rmw implementation
+ * \param[out] statistics calls, blocked calls, timeouts, time blocked and overhead,
+ *   and the attached and ready entities of the last call
+ * \param[out] overhead histogram of the overhead of the calls, or `NULL`
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_wait_set_statistics(
+  const rmw_wait_set_t * wait_set,
+  WaitSetStatistics * statistics,
+  LatencyHistogram * overhead);
+
+/// Return the latency histograms of the samples taken by a subscription.
+/**
+ * The transport latency goes from the source timestamp set by the writer to
+ * the reception of the sample, and requires the clocks of remote hosts to be
+ * synchronized. The queueing latency goes from the reception to the take, and
+ * shows how long samples wait in the history before the executor gets to them.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] transport_latency histogram from source timestamp to reception
+ * \param[out] queueing_latency histogram from reception to take
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_latency_histograms(
+  const rmw_subscription_t * subscription,
+  LatencyHistogram * transport_latency,
+  LatencyHistogram * queueing_latency);
+
+/// Clear the latency histograms of a subscription.
+/**
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+reset_subscription_latency_histograms(const rmw_subscription_t * subscription);
+
+/// Return the round trip latency histogram of the requests of a client.
+/**
+ * The latency goes from the sending of a request to the reception of its response,
+ * and is recorded once the response is taken. Only the responses to the last
+ * 1024 requests are recorded, and the calls per second follow from the
+ * statistics of the client.
+ *
+ * \param[in] client client handle from this rmw implementation
+ * \param[out] round_trip_latency histogram from request sending to response reception
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_client_round_trip_latency(
+  const rmw_client_t * client, LatencyHistogram * round_trip_latency);
+
+/// Clear the round trip latency histogram of a client.
+/**
+ * The responses to the requests sent before the reset are not recorded.
+ *
+ * \param[in] client client handle from this rmw implementation
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+reset_client_round_trip_latency(const rmw_client_t * client);
+
+/// Return the message rate, bandwidth and message sizes of a publisher.
+/**
+ * They are computed as messages are published, so tools can read them
+ * without subscribing to the topic and deserializing its messages.
+ *
+ * \param[in] publisher publisher handle from this rmw implementation
+ * \param[out] statistics rates over the last second and size distribution
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_publisher_rate_statistics(const rmw_publisher_t * publisher, RateStatistics * statistics);
+
+/// Return the message rate, bandwidth and message sizes received by a subscription.
+/**
+ * Samples are accounted for by their reception time when they are removed from
+ * the history, including the ones then discarded by a take filter.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] statistics rates over the last second and size distribution
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_rate_statistics(
+  const rmw_subscription_t * subscription, RateStatistics * statistics);
+
+/// Return the number of samples a subscription received and lost.
+/**
+ * Losses are detected from gaps in the sequence numbers of each matched writer,
+ * whether the samples were dropped by the network, or overwritten in a KEEP_LAST
+ * history before being taken. Best effort subscriptions with a deep enough history
+ * thus only report the samples lost in transport.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] statistics received, lost and out of order samples, and raised alarms
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_sample_loss(
+  const rmw_subscription_t * subscription, SampleLossStatistics * statistics);
+
+/// Trigger a guard condition when a subscription loses too many samples.
+/**
+ * The samples expected from the writers are grouped in windows of `window` samples,
+ * and the guard condition is triggered at the end of every window of which at least
+ * `loss_ratio` samples were lost, waking up any wait set it is attached to.
+ * The guard condition must outlive the subscription, or the alarm be disabled first.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[in] loss_ratio ratio of lost samples raising the alarm, in (0, 1]
+ * \param[in] window number of expected samples over which the ratio is computed
+ * \param[in] guard_condition guard condition to trigger, or `NULL` to disable the alarm
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+set_subscription_sample_loss_alarm(
+  const rmw_subscription_t * subscription,
+  double loss_ratio,
+  size_t window,
+  const rmw_guard_condition_t * guard_condition);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__STATISTICS_HPP_
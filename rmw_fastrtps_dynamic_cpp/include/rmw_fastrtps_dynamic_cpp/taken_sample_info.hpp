@@ -0,0 +1,67 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__TAKEN_SAMPLE_INFO_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__TAKEN_SAMPLE_INFO_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_shared_cpp/taken_sample_info.hpp"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+using TakenSampleInfo = rmw_fastrtps_shared_cpp::TakenSampleInfo;
+
+/// Return the timestamps and sequence number of the last sample taken by a subscription.
+/**
+ * `rmw_message_info_t` only carries the GID of the publisher, so this completes it
+ * right after a successful take, either deserialized or serialized, with or without info.
+ * It must be called from the thread which took the sample.
+ *
+ * \param[in] subscription subscription handle from this rmw implementation
+ * \param[out] sample_info source and reception timestamps and writer sequence number
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_subscription_taken_sample_info(
+  const rmw_subscription_t * subscription, TakenSampleInfo * sample_info);
+
+/// Return the timestamps and sequence number of the last request taken by a service.
+/**
+ * \param[in] service service handle from this rmw implementation
+ * \param[out] sample_info source and reception timestamps and writer sequence number
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_service_taken_request_info(const rmw_service_t * service, TakenSampleInfo * sample_info);
+
+/// Return the timestamps and sequence number of the last response taken by a client.
+/**
+ * The sequence number is the one of the response, while the request header
+ * filled by the take holds the one of the request.
+ *
+ * \param[in] client client handle from this rmw implementation
+ * \param[out] sample_info source and reception timestamps and writer sequence number
+ * \return `RMW_RET_OK` if successful, otherwise `RMW_RET_ERROR`
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+get_client_taken_response_info(const rmw_client_t * client, TakenSampleInfo * sample_info);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__TAKEN_SAMPLE_INFO_HPP_
@@ -0,0 +1,818 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+
+#include "rmw_fastrtps_dynamic_cpp/content_filter.hpp"
+#include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+
+#include "type_support_common.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+namespace
+{
+
+enum class Operator
+{
+  EQUAL,
+  NOT_EQUAL,
+  LESS,
+  LESS_EQUAL,
+  GREATER,
+  GREATER_EQUAL
+};
+
+enum class LiteralKind
+{
+  NEGATIVE_INTEGER,
+  INTEGER,
+  FLOATING,
+  STRING
+};
+
+struct Condition
+{
+  Operator op;
+  LiteralKind kind;
+  int64_t signed_value;
+  uint64_t unsigned_value;
+  double floating_value;
+  std::string string_value;
+};
+
+// Members of one message which have to be read to evaluate the conditions
+struct FieldNode
+{
+  // indices of the conditions on each primitive member
+  std::vector<std::vector<size_t>> conditions;
+  // nodes of the nested message members
+  std::vector<std::unique_ptr<FieldNode>> children;
+  // one past the last member which has to be read
+  uint32_t end = 0;
+};
+
+struct Token
+{
+  enum Kind
+  {
+    IDENTIFIER,
+    NUMBER,
+    STRING,
+    OPERATOR,
+    END,
+    INVALID
+  };
+
+  Kind kind;
+  std::string text;
+};
+
+class Lexer
+{
+public:
+  explicit Lexer(const char * expression)
+  : current_(expression) {}
+
+  Token
+  next()
+  {
+    while (isspace(static_cast<unsigned char>(*current_))) {
+      ++current_;
+    }
+    const char * begin = current_;
+    char c = *current_;
+    if ('\0' == c) {
+      return {Token::END, ""};
+    }
+    if (isalpha(static_cast<unsigned char>(c)) || '_' == c) {
+      while (isalnum(static_cast<unsigned char>(*current_)) || '_' == *current_ ||
+        '.' == *current_)
+      {
+        ++current_;
+      }
+      return {Token::IDENTIFIER, std::string(begin, current_)};
+    }
+    if (isdigit(static_cast<unsigned char>(c)) || '-' == c || '+' == c || '.' == c) {
+      ++current_;
+      while (isalnum(static_cast<unsigned char>(*current_)) || '.' == *current_ ||
+        (('-' == *current_ || '+' == *current_) &&
+        ('e' == current_[-1] || 'E' == current_[-1])))
+      {
+        ++current_;
+      }
+      return {Token::NUMBER, std::string(begin, current_)};
+    }
+    if ('\'' == c || '"' == c) {
+      const char * end = strchr(begin + 1, c);
+      if (!end) {
+        return {Token::INVALID, std::string(begin)};
+      }
+      current_ = end + 1;
+      return {Token::STRING, std::string(begin + 1, end)};
+    }
+    static const char * operators[] = {"==", "!=", "<=", ">=", "&&", "<", ">", "="};
+    for (const char * op : operators) {
+      size_t length = strlen(op);
+      if (strncmp(current_, op, length) == 0) {
+        current_ += length;
+        return {Token::OPERATOR, op};
+      }
+    }
+    return {Token::INVALID, std::string(begin)};
+  }
+
+private:
+  const char * current_;
+};
+
+bool
+parse_operator(const std::string & text, Operator & op)
+{
+  if (text == "==" || text == "=") {
+    op = Operator::EQUAL;
+  } else if (text == "!=") {
+    op = Operator::NOT_EQUAL;
+  } else if (text == "<") {
+    op = Operator::LESS;
+  } else if (text == "<=") {
+    op = Operator::LESS_EQUAL;
+  } else if (text == ">") {
+    op = Operator::GREATER;
+  } else if (text == ">=") {
+    op = Operator::GREATER_EQUAL;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool
+parse_literal(const Token & token, Condition & condition)
+{
+  condition.signed_value = 0;
+  condition.unsigned_value = 0;
+  condition.floating_value = 0.0;
+  if (Token::STRING == token.kind) {
+    condition.kind = LiteralKind::STRING;
+    condition.string_value = token.text;
+    return true;
+  }
+  if (Token::IDENTIFIER == token.kind && (token.text == "true" || token.text == "false")) {
+    condition.kind = LiteralKind::INTEGER;
+    condition.unsigned_value = token.text == "true" ? 1 : 0;
+    condition.floating_value = static_cast<double>(condition.unsigned_value);
+    return true;
+  }
+  if (Token::NUMBER != token.kind) {
+    return false;
+  }
+
+  const char * text = token.text.c_str();
+  char * end = nullptr;
+  errno = 0;
+  condition.floating_value = strtod(text, &end);
+  if (*end != '\0' || errno == ERANGE) {
+    return false;
+  }
+  if (token.text.find_first_of(".eE") != std::string::npos) {
+    condition.kind = LiteralKind::FLOATING;
+    return true;
+  }
+  errno = 0;
+  if ('-' == text[0]) {
+    condition.kind = LiteralKind::NEGATIVE_INTEGER;
+    condition.signed_value = strtoll(text, &end, 10);
+  } else {
+    condition.kind = LiteralKind::INTEGER;
+    condition.unsigned_value = strtoull(text, &end, 10);
+  }
+  return *end == '\0' && errno != ERANGE;
+}
+
+// Three-way comparisons of a field value with a literal, 2 meaning unordered
+int
+compare_floating(double value, const Condition & condition)
+{
+  if (value < condition.floating_value) {
+    return -1;
+  }
+  if (value > condition.floating_value) {
+    return 1;
+  }
+  return value == condition.floating_value ? 0 : 2;
+}
+
+int
+compare_signed(int64_t value, const Condition & condition)
+{
+  switch (condition.kind) {
+    case LiteralKind::FLOATING:
+      return compare_floating(static_cast<double>(value), condition);
+    case LiteralKind::NEGATIVE_INTEGER:
+      return value < condition.signed_value ? -1 : (value > condition.signed_value ? 1 : 0);
+    default:
+      if (value < 0) {
+        return -1;
+      }
+      {
+        auto unsigned_value = static_cast<uint64_t>(value);
+        return unsigned_value < condition.unsigned_value ?
+               -1 : (unsigned_value > condition.unsigned_value ? 1 : 0);
+      }
+  }
+}
+
+int
+compare_unsigned(uint64_t value, const Condition & condition)
+{
+  switch (condition.kind) {
+    case LiteralKind::FLOATING:
+      return compare_floating(static_cast<double>(value), condition);
+    case LiteralKind::NEGATIVE_INTEGER:
+      return 1;
+    default:
+      return value < condition.unsigned_value ? -1 : (value > condition.unsigned_value ? 1 : 0);
+  }
+}
+
+int
+compare_string(const std::string & value, const Condition & condition)
+{
+  int result = value.compare(condition.string_value);
+  return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+bool
+apply(Operator op, int comparison)
+{
+  if (2 == comparison) {
+    return Operator::NOT_EQUAL == op;
+  }
+  switch (op) {
+    case Operator::EQUAL:
+      return 0 == comparison;
+    case Operator::NOT_EQUAL:
+      return 0 != comparison;
+    case Operator::LESS:
+      return comparison < 0;
+    case Operator::LESS_EQUAL:
+      return comparison <= 0;
+    case Operator::GREATER:
+      return comparison > 0;
+    case Operator::GREATER_EQUAL:
+      return comparison >= 0;
+  }
+  return false;
+}
+
+// Whether members of that type can be read or skipped in a serialized sample
+bool
+is_readable_type(uint8_t type_id)
+{
+  switch (type_id) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Check that a member, and all the members of a nested message, can be read or skipped
+template<typename MembersType, typename MemberType>
+bool
+validate_member(const MemberType * member, std::string & error)
+{
+  if (!is_readable_type(member->type_id_)) {
+    error = std::string("field '") + member->name_ + "' has a type which cannot be read";
+    return false;
+  }
+  if (::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE == member->type_id_) {
+    auto sub_members = static_cast<const MembersType *>(member->members_->data);
+    for (uint32_t i = 0; i < sub_members->member_count_; ++i) {
+      if (!validate_member<MembersType>(sub_members->members_ + i, error)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void
+jump(eprosima::fastcdr::Cdr & deser, size_t size)
+{
+  if (size && !deser.jump(size)) {
+    throw std::runtime_error("sample is shorter than its type");
+  }
+}
+
+// Skip a sequence of primitives, reading the first one so that it gets aligned
+template<typename T>
+void
+skip_primitives(eprosima::fastcdr::Cdr & deser, size_t count)
+{
+  T first;
+  deser >> first;
+  jump(deser, (count - 1) * sizeof(T));
+}
+
+template<typename MembersType, typename MemberType>
+void
+skip_member(eprosima::fastcdr::Cdr & deser, const MemberType * member)
+{
+  size_t count = 1;
+  if (member->is_array_) {
+    if (member->array_size_ && !member->is_upper_bound_) {
+      count = member->array_size_;
+    } else {
+      uint32_t size = 0;
+      deser >> size;
+      count = size;
+    }
+  }
+  if (0 == count) {
+    return;
+  }
+
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      skip_primitives<uint8_t>(deser, count);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      skip_primitives<uint16_t>(deser, count);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      skip_primitives<uint32_t>(deser, count);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      skip_primitives<uint64_t>(deser, count);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      for (size_t index = 0; index < count; ++index) {
+        // the length includes the null terminator
+        uint32_t length = 0;
+        deser >> length;
+        jump(deser, length);
+      }
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      {
+        auto sub_members = static_cast<const MembersType *>(member->members_->data);
+        for (size_t index = 0; index < count; ++index) {
+          for (uint32_t i = 0; i < sub_members->member_count_; ++i) {
+            skip_member<MembersType>(deser, sub_members->members_ + i);
+          }
+        }
+      }
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
+template<typename MembersType>
+class ContentFilter
+{
+public:
+  explicit ContentFilter(const MembersType * members)
+  : members_(members)
+  {
+    init_node(root_, members_);
+  }
+
+  bool
+  parse(const char * expression, std::string & error)
+  {
+    Lexer lexer(expression);
+    while (true) {
+      Token field = lexer.next();
+      if (Token::IDENTIFIER != field.kind) {
+        error = "expected a field name instead of '" + field.text + "'";
+        return false;
+      }
+      Token op = lexer.next();
+      Condition condition;
+      if (Token::OPERATOR != op.kind || !parse_operator(op.text, condition.op)) {
+        error = "expected a comparison operator after '" + field.text + "'";
+        return false;
+      }
+      Token literal = lexer.next();
+      if (!parse_literal(literal, condition)) {
+        error = "invalid literal '" + literal.text + "'";
+        return false;
+      }
+      if (!add_condition(field.text, condition, error)) {
+        return false;
+      }
+
+      Token separator = lexer.next();
+      if (Token::END == separator.kind) {
+        // the samples are then never dropped for a type the filter cannot read
+        return validate(members_, root_, true, error);
+      }
+      if (separator.text != "AND" && separator.text != "and" && separator.text != "&&") {
+        error = "expected AND instead of '" + separator.text + "'";
+        return false;
+      }
+    }
+  }
+
+  bool
+  matches(eprosima::fastcdr::FastBuffer & buffer) const
+  {
+    eprosima::fastcdr::Cdr deser(
+      buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+    try {
+      deser.read_encapsulation();
+      return evaluate(deser, members_, root_, true);
+    } catch (const std::exception &) {
+      // a malformed sample could not be deserialized either
+      return false;
+    }
+  }
+
+private:
+  static void
+  init_node(FieldNode & node, const MembersType * members)
+  {
+    node.conditions.resize(members->member_count_);
+    node.children.resize(members->member_count_);
+  }
+
+  bool
+  add_condition(const std::string & path, const Condition & condition, std::string & error)
+  {
+    FieldNode * node = &root_;
+    const MembersType * members = members_;
+    size_t begin = 0;
+    while (true) {
+      size_t end = path.find('.', begin);
+      std::string name = path.substr(begin, end == std::string::npos ? end : end - begin);
+
+      uint32_t index = 0;
+      while (index < members->member_count_ && name != members->members_[index].name_) {
+        ++index;
+      }
+      if (index == members->member_count_) {
+        error = "unknown field '" + path + "'";
+        return false;
+      }
+      const auto * member = members->members_ + index;
+      if (member->is_array_) {
+        error = "field '" + path + "' is an array";
+        return false;
+      }
+      if (index + 1 > node->end) {
+        node->end = index + 1;
+      }
+
+      if (end == std::string::npos) {
+        if (::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE == member->type_id_) {
+          error = "field '" + path + "' is a message";
+          return false;
+        }
+        bool is_string =
+          ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING == member->type_id_;
+        if (is_string != (LiteralKind::STRING == condition.kind)) {
+          error = "field '" + path + "' cannot be compared with that literal";
+          return false;
+        }
+        node->conditions[index].push_back(conditions_.size());
+        conditions_.push_back(condition);
+        return true;
+      }
+
+      if (::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE != member->type_id_) {
+        error = "field '" + path.substr(0, end) + "' is not a message";
+        return false;
+      }
+      members = static_cast<const MembersType *>(member->members_->data);
+      if (!node->children[index]) {
+        node->children[index].reset(new FieldNode());
+        init_node(*node->children[index], members);
+      }
+      node = node->children[index].get();
+      begin = end + 1;
+    }
+  }
+
+  // Check that every member evaluate() reads or skips has a type it can read
+  static bool
+  validate(
+    const MembersType * members, const FieldNode & node, bool may_stop, std::string & error)
+  {
+    uint32_t count = may_stop ? node.end : members->member_count_;
+    for (uint32_t i = 0; i < count; ++i) {
+      const auto * member = members->members_ + i;
+      if (node.children[i]) {
+        auto sub_members = static_cast<const MembersType *>(member->members_->data);
+        if (!validate(sub_members, *node.children[i], may_stop && i + 1 == node.end, error)) {
+          return false;
+        }
+      } else if (!validate_member<MembersType>(member, error)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<typename Compare>
+  bool
+  check(const std::vector<size_t> & conditions, Compare compare) const
+  {
+    for (size_t index : conditions) {
+      const Condition & condition = conditions_[index];
+      if (!apply(condition.op, compare(condition))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<typename T>
+  bool
+  check_signed(eprosima::fastcdr::Cdr & deser, const std::vector<size_t> & conditions) const
+  {
+    T value;
+    deser >> value;
+    return check(conditions, [value](const Condition & condition) {
+               return compare_signed(static_cast<int64_t>(value), condition);
+             });
+  }
+
+  template<typename T>
+  bool
+  check_unsigned(eprosima::fastcdr::Cdr & deser, const std::vector<size_t> & conditions) const
+  {
+    T value;
+    deser >> value;
+    return check(conditions, [value](const Condition & condition) {
+               return compare_unsigned(static_cast<uint64_t>(value), condition);
+             });
+  }
+
+  template<typename T>
+  bool
+  check_floating(eprosima::fastcdr::Cdr & deser, const std::vector<size_t> & conditions) const
+  {
+    T value;
+    deser >> value;
+    return check(conditions, [value](const Condition & condition) {
+               return compare_floating(static_cast<double>(value), condition);
+             });
+  }
+
+  bool
+  check_field(
+    eprosima::fastcdr::Cdr & deser, uint8_t type_id,
+    const std::vector<size_t> & conditions) const
+  {
+    switch (type_id) {
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+        {
+          bool value = false;
+          deser >> value;
+          return check(conditions, [value](const Condition & condition) {
+                     return compare_unsigned(value ? 1 : 0, condition);
+                   });
+        }
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+        return check_unsigned<uint8_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+        {
+          char value = 0;
+          deser >> value;
+          return check(conditions, [value](const Condition & condition) {
+                     return compare_signed(static_cast<int8_t>(value), condition);
+                   });
+        }
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+        return check_floating<float>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+        return check_floating<double>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+        return check_signed<int16_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+        return check_unsigned<uint16_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+        return check_signed<int32_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+        return check_unsigned<uint32_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+        return check_signed<int64_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+        return check_unsigned<uint64_t>(deser, conditions);
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+        {
+          std::string value;
+          deser >> value;
+          return check(conditions, [&value](const Condition & condition) {
+                     return compare_string(value, condition);
+                   });
+        }
+      default:
+        throw std::runtime_error("unknown type");
+    }
+  }
+
+  // Read the members needed by the conditions, returning false as soon as one fails.
+  // Once the last needed member is read, the rest of the sample is left unread.
+  bool
+  evaluate(
+    eprosima::fastcdr::Cdr & deser, const MembersType * members,
+    const FieldNode & node, bool may_stop) const
+  {
+    uint32_t count = may_stop ? node.end : members->member_count_;
+    for (uint32_t i = 0; i < count; ++i) {
+      const auto * member = members->members_ + i;
+      if (node.children[i]) {
+        auto sub_members = static_cast<const MembersType *>(member->members_->data);
+        if (!evaluate(deser, sub_members, *node.children[i], may_stop && i + 1 == node.end)) {
+          return false;
+        }
+      } else if (!node.conditions[i].empty()) {
+        if (!check_field(deser, member->type_id_, node.conditions[i])) {
+          return false;
+        }
+      } else {
+        skip_member<MembersType>(deser, member);
+      }
+    }
+    return true;
+  }
+
+  const MembersType * members_;
+  FieldNode root_;
+  std::vector<Condition> conditions_;
+};
+
+/// Compile an expression, or return null with the error message set.
+template<typename MembersType>
+std::shared_ptr<ContentFilter<MembersType>>
+_parse_content_filter(const MembersType * members, const char * filter_expression)
+{
+  auto filter = std::make_shared<ContentFilter<MembersType>>(members);
+  std::string error;
+  if (!filter->parse(filter_expression, error)) {
+    error = "invalid content filter expression: " + error;
+    RMW_SET_ERROR_MSG(error.c_str());
+    return nullptr;
+  }
+  return filter;
+}
+
+template<typename MembersType>
+rmw_ret_t
+_set_content_filter(
+  CustomSubscriberInfo * info, const MembersType * members, const char * filter_expression)
+{
+  auto filter = _parse_content_filter(members, filter_expression);
+  if (!filter) {
+    return RMW_RET_ERROR;
+  }
+  auto sample_filter = std::make_shared<const SampleFilter>(
+    [filter](eprosima::fastcdr::FastBuffer & buffer) {
+      return filter->matches(buffer);
+    });
+  std::atomic_store(&info->content_filter_, sample_filter);
+  return RMW_RET_OK;
+}
+
+template<typename MembersType>
+rmw_ret_t
+_evaluate_content_filter(
+  const MembersType * members, const char * filter_expression,
+  const rmw_serialized_message_t * serialized_message, bool * matches)
+{
+  auto filter = _parse_content_filter(members, filter_expression);
+  if (!filter) {
+    return RMW_RET_ERROR;
+  }
+  eprosima::fastcdr::FastBuffer buffer(
+    reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
+  *matches = filter->matches(buffer);
+  return RMW_RET_OK;
+}
+
+}  // namespace
+
+rmw_ret_t
+set_subscription_content_filter(
+  const rmw_subscription_t * subscription, const char * filter_expression)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+  if (subscription->implementation_identifier != eprosima_fastrtps_identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (!filter_expression || '\0' == filter_expression[0]) {
+    std::atomic_store(&info->content_filter_, std::shared_ptr<const SampleFilter>());
+    return RMW_RET_OK;
+  }
+
+  if (using_introspection_c_typesupport(info->typesupport_identifier_)) {
+    auto type_support = static_cast<TypeSupport_c *>(info->type_support_);
+    return _set_content_filter(info, type_support->members(), filter_expression);
+  } else if (using_introspection_cpp_typesupport(info->typesupport_identifier_)) {
+    auto type_support = static_cast<TypeSupport_cpp *>(info->type_support_);
+    return _set_content_filter(info, type_support->members(), filter_expression);
+  }
+  RMW_SET_ERROR_MSG("Unknown typesupport identifier");
+  return RMW_RET_ERROR;
+}
+
+rmw_ret_t
+evaluate_content_filter(
+  const rosidl_message_type_support_t * type_support, const char * filter_expression,
+  const rmw_serialized_message_t * serialized_message, bool * matches)
+{
+  if (!type_support || !serialized_message || !matches) {
+    RMW_SET_ERROR_MSG("type_support, serialized_message and matches must not be null");
+    return RMW_RET_ERROR;
+  }
+  if (!filter_expression || '\0' == filter_expression[0]) {
+    *matches = true;
+    return RMW_RET_OK;
+  }
+
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (ts) {
+    return _evaluate_content_filter(
+      static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(ts->data),
+      filter_expression, serialized_message, matches);
+  }
+  ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+  if (ts) {
+    return _evaluate_content_filter(
+      static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(ts->data),
+      filter_expression, serialized_message, matches);
+  }
+  RMW_SET_ERROR_MSG("type support not from this implementation");
+  return RMW_RET_ERROR;
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
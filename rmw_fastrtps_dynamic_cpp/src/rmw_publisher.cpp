@@ -20,6 +20,7 @@
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/endpoint_attributes.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 
@@ -109,9 +110,14 @@ rmw_create_publisher(
   }
 
   if (!impl->leave_middleware_default_qos) {
-    publisherParam.qos.m_publishMode.kind = eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
-    publisherParam.historyMemoryPolicy =
-      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    bool high_priority = rmw_fastrtps_shared_cpp::is_high_priority_topic(impl, topic_name);
+    publisherParam.qos.m_publishMode.kind = rmw_fastrtps_shared_cpp::get_publish_mode(
+      impl->publishing_mode, high_priority, info->type_support_);
+    // Only asynchronous writers are affected by the throughput controller
+    if (!high_priority) {
+      publisherParam.throughputController = impl->publisher_throughput_controller;
+    }
+    publisherParam.times = impl->writer_times;
   }
 
   publisherParam.topic.topicKind = eprosima::fastrtps::rtps::NO_KEY;
@@ -122,18 +128,15 @@ rmw_create_publisher(
     publisherParam.topic.topicName = topic_name;
   }
 
-  // 1 Heartbeat every 10ms
-  // publisherParam.times.heartbeatPeriod.seconds = 0;
-  // publisherParam.times.heartbeatPeriod.fraction = 42949673;
-
-  // 300000 bytes each 10ms
-  // ThroughputControllerDescriptor throughputController{3000000, 10};
-  // publisherParam.throughputController = throughputController;
-
   if (!get_datawriter_qos(*qos_policies, publisherParam)) {
     RMW_SET_ERROR_MSG("failed to get datawriter qos");
     goto fail;
   }
+  if (!impl->leave_middleware_default_qos) {
+    rmw_fastrtps_shared_cpp::set_resource_limits(impl, publisherParam.topic);
+    rmw_fastrtps_shared_cpp::set_history_memory_policy(
+      impl, info->type_support_, publisherParam.topic, publisherParam.historyMemoryPolicy);
+  }
 
   info->listener_ = new (std::nothrow) PubListener(info);
   if (!info->listener_) {
@@ -146,6 +149,8 @@ rmw_create_publisher(
     RMW_SET_ERROR_MSG("create_publisher() could not create publisher");
     goto fail;
   }
+  info->preallocated_history_size_ = rmw_fastrtps_shared_cpp::get_preallocated_history_size(
+    info->type_support_, publisherParam.topic, publisherParam.historyMemoryPolicy);
 
   info->publisher_gid.implementation_identifier = eprosima_fastrtps_identifier;
   static_assert(
@@ -176,6 +181,8 @@ rmw_create_publisher(
   }
 
   memcpy(const_cast<char *>(rmw_publisher->topic_name), topic_name, strlen(topic_name) + 1);
+  impl->entity_counters.add(&info->counters_);
+  rmw_fastrtps_shared_cpp::export_publisher_statistics(node, info, topic_name);
   return rmw_publisher;
 
 fail:
@@ -0,0 +1,164 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw_fastrtps_dynamic_cpp/statistics.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+rmw_ret_t
+get_publisher_history_overflow_count(const rmw_publisher_t * publisher, uint64_t * count)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_publisher_history_overflow_count(
+    eprosima_fastrtps_identifier, publisher, count);
+}
+
+rmw_ret_t
+get_subscription_history_overflow_count(
+  const rmw_subscription_t * subscription, uint64_t * count)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_history_overflow_count(
+    eprosima_fastrtps_identifier, subscription, count);
+}
+
+rmw_ret_t
+get_subscription_expired_sample_count(
+  const rmw_subscription_t * subscription, uint64_t * count)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_expired_sample_count(
+    eprosima_fastrtps_identifier, subscription, count);
+}
+
+rmw_ret_t
+get_publisher_statistics(const rmw_publisher_t * publisher, EntityStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_publisher_statistics(
+    eprosima_fastrtps_identifier, publisher, statistics);
+}
+
+rmw_ret_t
+get_subscription_statistics(const rmw_subscription_t * subscription, EntityStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_statistics(
+    eprosima_fastrtps_identifier, subscription, statistics);
+}
+
+rmw_ret_t
+get_service_statistics(const rmw_service_t * service, EntityStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_service_statistics(
+    eprosima_fastrtps_identifier, service, statistics);
+}
+
+rmw_ret_t
+get_client_statistics(const rmw_client_t * client, EntityStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_client_statistics(
+    eprosima_fastrtps_identifier, client, statistics);
+}
+
+rmw_ret_t
+get_node_statistics(const rmw_node_t * node, EntityStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_node_statistics(
+    eprosima_fastrtps_identifier, node, statistics);
+}
+
+rmw_ret_t
+get_node_discovery_statistics(const rmw_node_t * node, DiscoveryStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_node_discovery_statistics(
+    eprosima_fastrtps_identifier, node, statistics);
+}
+
+rmw_ret_t
+get_wait_set_statistics(
+  const rmw_wait_set_t * wait_set,
+  WaitSetStatistics * statistics,
+  LatencyHistogram * overhead)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_wait_set_statistics(
+    eprosima_fastrtps_identifier, wait_set, statistics, overhead);
+}
+
+rmw_ret_t
+get_subscription_latency_histograms(
+  const rmw_subscription_t * subscription,
+  LatencyHistogram * transport_latency,
+  LatencyHistogram * queueing_latency)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_latency_histograms(
+    eprosima_fastrtps_identifier, subscription, transport_latency, queueing_latency);
+}
+
+rmw_ret_t
+reset_subscription_latency_histograms(const rmw_subscription_t * subscription)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_reset_subscription_latency_histograms(
+    eprosima_fastrtps_identifier, subscription);
+}
+
+rmw_ret_t
+get_client_round_trip_latency(
+  const rmw_client_t * client, LatencyHistogram * round_trip_latency)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_client_round_trip_latency(
+    eprosima_fastrtps_identifier, client, round_trip_latency);
+}
+
+rmw_ret_t
+reset_client_round_trip_latency(const rmw_client_t * client)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_reset_client_round_trip_latency(
+    eprosima_fastrtps_identifier, client);
+}
+
+rmw_ret_t
+get_publisher_rate_statistics(const rmw_publisher_t * publisher, RateStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_publisher_rate_statistics(
+    eprosima_fastrtps_identifier, publisher, statistics);
+}
+
+rmw_ret_t
+get_subscription_rate_statistics(
+  const rmw_subscription_t * subscription, RateStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_rate_statistics(
+    eprosima_fastrtps_identifier, subscription, statistics);
+}
+
+rmw_ret_t
+get_subscription_sample_loss(
+  const rmw_subscription_t * subscription, SampleLossStatistics * statistics)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_get_subscription_sample_loss(
+    eprosima_fastrtps_identifier, subscription, statistics);
+}
+
+rmw_ret_t
+set_subscription_sample_loss_alarm(
+  const rmw_subscription_t * subscription,
+  double loss_ratio,
+  size_t window,
+  const rmw_guard_condition_t * guard_condition)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_set_subscription_sample_loss_alarm(
+    eprosima_fastrtps_identifier, subscription, loss_ratio, window, guard_condition);
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
@@ -0,0 +1,233 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/serialized_message.h"
+#include "rmw/rmw.h"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "test_msgs/msg/dynamic_array_primitives.hpp"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/primitives.hpp"
+
+#include "rmw_fastrtps_dynamic_cpp/content_filter.hpp"
+
+class TestContentFilter : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    serialized_message_ = rmw_get_zero_initialized_serialized_message();
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message_, 0, &allocator));
+
+    primitives_.bool_value = true;
+    primitives_.byte_value = 200;
+    primitives_.char_value = 'c';
+    primitives_.float32_value = 0.5f;
+    primitives_.float64_value = -2.25;
+    primitives_.int8_value = -3;
+    primitives_.uint8_value = 7;
+    primitives_.int16_value = -1000;
+    primitives_.uint16_value = 1000;
+    primitives_.int32_value = 42;
+    primitives_.uint32_value = 4000000000u;
+    primitives_.int64_value = -5000000000ll;
+    primitives_.uint64_value = 10000000000000000000ull;
+    primitives_.string_value = "map";
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message_));
+  }
+
+  /// Serialize the message, and return whether it matches the expression.
+  template<typename MessageT>
+  ::testing::AssertionResult
+  matches(const MessageT & message, const char * expression)
+  {
+    auto type_support = rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+    if (rmw_serialize(&message, type_support, &serialized_message_) != RMW_RET_OK) {
+      std::string error = rmw_get_error_string().str;
+      rmw_reset_error();
+      return ::testing::AssertionFailure() << "rmw_serialize failed: " << error;
+    }
+    return evaluate(type_support, expression);
+  }
+
+  ::testing::AssertionResult
+  evaluate(const rosidl_message_type_support_t * type_support, const char * expression)
+  {
+    bool matched = false;
+    rmw_ret_t ret = rmw_fastrtps_dynamic_cpp::evaluate_content_filter(
+      type_support, expression, &serialized_message_, &matched);
+    expression = expression ? expression : "(null)";
+    if (ret != RMW_RET_OK) {
+      std::string error = rmw_get_error_string().str;
+      rmw_reset_error();
+      return ::testing::AssertionFailure() << "'" << expression << "' rejected: " << error;
+    }
+    if (!matched) {
+      return ::testing::AssertionFailure() << "'" << expression << "' does not match";
+    }
+    return ::testing::AssertionSuccess() << "'" << expression << "' matches";
+  }
+
+  /// Return whether the expression is rejected for the type of the message.
+  template<typename MessageT>
+  bool
+  rejected(const char * expression)
+  {
+    MessageT message;
+    EXPECT_EQ(
+      RMW_RET_OK,
+      rmw_serialize(
+        &message, rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(),
+        &serialized_message_));
+    bool matched = false;
+    rmw_ret_t ret = rmw_fastrtps_dynamic_cpp::evaluate_content_filter(
+      rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(), expression,
+      &serialized_message_, &matched);
+    rmw_reset_error();
+    return RMW_RET_ERROR == ret;
+  }
+
+  rmw_serialized_message_t serialized_message_;
+  test_msgs::msg::Primitives primitives_;
+};
+
+TEST_F(TestContentFilter, empty_expression_matches_everything) {
+  EXPECT_TRUE(matches(primitives_, ""));
+  EXPECT_TRUE(matches(primitives_, nullptr));
+}
+
+TEST_F(TestContentFilter, comparisons_bind_tighter_than_and) {
+  EXPECT_TRUE(matches(primitives_, "int32_value == 42 AND bool_value == true"));
+  EXPECT_FALSE(matches(primitives_, "int32_value == 42 AND bool_value == false"));
+  EXPECT_FALSE(matches(primitives_, "int32_value == 41 AND bool_value == true"));
+  EXPECT_TRUE(matches(primitives_, "int32_value>41&&int32_value<43"));
+  EXPECT_TRUE(matches(primitives_, "int32_value = 42 and string_value == 'map'"));
+  // the order of the conditions does not matter, whatever the order of the fields
+  EXPECT_TRUE(matches(primitives_, "string_value == \"map\" AND bool_value == true"));
+}
+
+TEST_F(TestContentFilter, malformed_expressions_are_rejected) {
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value =="));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("== 42"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("42 == int32_value"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value ~ 42"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value == 42 AND"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value == 42 int8_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value == 42 OR int8_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("(int32_value == 42)"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("string_value == 'map"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value == 42abc"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("float64_value == 1e999"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("uint64_value == 99999999999999999999"));
+}
+
+TEST_F(TestContentFilter, unknown_fields_are_rejected) {
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("missing_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("Int32_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value.sub == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Nested>("primitive_values.missing_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Nested>("missing_values.int32_value == 1"));
+}
+
+TEST_F(TestContentFilter, fields_which_cannot_be_compared_are_rejected) {
+  EXPECT_TRUE(rejected<test_msgs::msg::Nested>("primitive_values == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::DynamicArrayPrimitives>("int32_values == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("string_value == 1"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("int32_value == 'map'"));
+  EXPECT_TRUE(rejected<test_msgs::msg::Primitives>("bool_value == 'true'"));
+}
+
+TEST_F(TestContentFilter, integers) {
+  EXPECT_TRUE(matches(primitives_, "int8_value == -3"));
+  EXPECT_TRUE(matches(primitives_, "int8_value < 0"));
+  EXPECT_TRUE(matches(primitives_, "int8_value > -4"));
+  EXPECT_TRUE(matches(primitives_, "int16_value <= -1000"));
+  EXPECT_TRUE(matches(primitives_, "int16_value != 1000"));
+  EXPECT_TRUE(matches(primitives_, "uint16_value >= 1000"));
+  EXPECT_FALSE(matches(primitives_, "uint16_value > 1000"));
+  EXPECT_TRUE(matches(primitives_, "uint32_value == 4000000000"));
+  EXPECT_TRUE(matches(primitives_, "int64_value < -4999999999"));
+  EXPECT_TRUE(matches(primitives_, "uint64_value == 10000000000000000000"));
+  EXPECT_TRUE(matches(primitives_, "byte_value == 200"));
+  EXPECT_TRUE(matches(primitives_, "uint8_value > -1"));
+  EXPECT_FALSE(matches(primitives_, "uint8_value == -7"));
+  EXPECT_TRUE(matches(primitives_, "int32_value < 42.5"));
+  EXPECT_FALSE(matches(primitives_, "int32_value == 42.5"));
+}
+
+TEST_F(TestContentFilter, floating_points) {
+  EXPECT_TRUE(matches(primitives_, "float32_value == 0.5"));
+  EXPECT_TRUE(matches(primitives_, "float32_value >= 5e-1"));
+  EXPECT_TRUE(matches(primitives_, "float64_value < -2"));
+  EXPECT_TRUE(matches(primitives_, "float64_value == -2.25"));
+  EXPECT_FALSE(matches(primitives_, "float64_value > -2.25"));
+}
+
+TEST_F(TestContentFilter, booleans_and_strings) {
+  EXPECT_TRUE(matches(primitives_, "bool_value == true"));
+  EXPECT_TRUE(matches(primitives_, "bool_value != false"));
+  EXPECT_TRUE(matches(primitives_, "bool_value == 1"));
+  EXPECT_TRUE(matches(primitives_, "string_value == 'map'"));
+  EXPECT_TRUE(matches(primitives_, "string_value != 'odom'"));
+  EXPECT_TRUE(matches(primitives_, "string_value < 'odom'"));
+  EXPECT_TRUE(matches(primitives_, "string_value > 'ma'"));
+  EXPECT_FALSE(matches(primitives_, "string_value == 'Map'"));
+  primitives_.string_value = "";
+  EXPECT_TRUE(matches(primitives_, "string_value == ''"));
+}
+
+TEST_F(TestContentFilter, nested_fields) {
+  test_msgs::msg::Nested nested;
+  nested.primitive_values = primitives_;
+  EXPECT_TRUE(matches(nested, "primitive_values.int32_value == 42"));
+  EXPECT_TRUE(
+    matches(nested, "primitive_values.string_value == 'map' AND primitive_values.int8_value < 0"));
+  EXPECT_FALSE(matches(nested, "primitive_values.bool_value == false"));
+}
+
+TEST_F(TestContentFilter, fields_after_sequences) {
+  test_msgs::msg::DynamicArrayPrimitives message;
+  message.bool_values = {true, false, true};
+  message.int16_values = {1, 2, 3, 4, 5};
+  message.float64_values = {1.5};
+  message.string_values = {"a", "", "longer string"};
+  message.check = 7;
+  // the sequences before the compared field are skipped
+  EXPECT_TRUE(matches(message, "check == 7"));
+  EXPECT_FALSE(matches(message, "check != 7"));
+}
+
+TEST_F(TestContentFilter, truncated_samples_do_not_match) {
+  ASSERT_TRUE(matches(primitives_, "string_value == 'map'"));
+  // down to the encapsulation
+  serialized_message_.buffer_length = 4;
+  EXPECT_FALSE(
+    evaluate(
+      rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Primitives>(),
+      "string_value == 'map'"));
+}
@@ -0,0 +1,335 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BENCHMARK_COMMON_HPP_
+#define BENCHMARK_COMMON_HPP_
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/qos_profiles.h"
+#include "rmw/rmw.h"
+
+namespace benchmark
+{
+
+inline int64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t
+cpu_ns(clockid_t clock)
+{
+  timespec time;
+  clock_gettime(clock, &time);
+  return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+inline int64_t
+process_cpu_ns()
+{
+  return cpu_ns(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+inline int64_t
+thread_cpu_ns()
+{
+  return cpu_ns(CLOCK_THREAD_CPUTIME_ID);
+}
+
+/// Exit with the rmw error message when a call failed.
+inline void
+check(rmw_ret_t ret, const char * call)
+{
+  if (ret != RMW_RET_OK) {
+    fprintf(stderr, "%s failed: %s\n", call, rmw_get_error_string().str);
+    exit(EXIT_FAILURE);
+  }
+}
+
+template<typename T>
+T *
+check(T * handle, const char * call)
+{
+  if (!handle) {
+    fprintf(stderr, "%s failed: %s\n", call, rmw_get_error_string().str);
+    exit(EXIT_FAILURE);
+  }
+  return handle;
+}
+
+/// Command line options given as `--name=value`, where lists are comma separated.
+class Options
+{
+public:
+  Options(int argc, char ** argv)
+  {
+    for (int i = 1; i < argc; ++i) {
+      std::string argument(argv[i]);
+      size_t equal = argument.find('=');
+      if (argument.compare(0, 2, "--") != 0 || equal == std::string::npos) {
+        fprintf(stderr, "unexpected argument '%s', options are given as --name=value\n", argv[i]);
+        exit(EXIT_FAILURE);
+      }
+      values_.emplace_back(argument.substr(2, equal - 2), argument.substr(equal + 1));
+    }
+  }
+
+  std::string
+  get(const char * name, const char * default_value) const
+  {
+    for (const auto & value : values_) {
+      if (value.first == name) {
+        return value.second;
+      }
+    }
+    return default_value;
+  }
+
+  std::vector<std::string>
+  list(const char * name, const char * default_value) const
+  {
+    std::vector<std::string> items;
+    std::string value = get(name, default_value);
+    size_t begin = 0;
+    while (begin <= value.size()) {
+      size_t end = value.find(',', begin);
+      if (end == std::string::npos) {
+        end = value.size();
+      }
+      if (end > begin) {
+        items.push_back(value.substr(begin, end - begin));
+      }
+      begin = end + 1;
+    }
+    return items;
+  }
+
+  uint64_t
+  number(const char * name, uint64_t default_value) const
+  {
+    std::string value = get(name, "");
+    return value.empty() ? default_value : parse_size(value);
+  }
+
+  std::vector<uint64_t>
+  numbers(const char * name, const char * default_value) const
+  {
+    std::vector<uint64_t> items;
+    for (const auto & item : list(name, default_value)) {
+      items.push_back(parse_size(item));
+    }
+    return items;
+  }
+
+  /// Parse a count or size, with an optional K or M binary suffix.
+  static uint64_t
+  parse_size(const std::string & value)
+  {
+    char * end = nullptr;
+    uint64_t number = strtoull(value.c_str(), &end, 10);
+    if (end == value.c_str()) {
+      fprintf(stderr, "invalid number '%s'\n", value.c_str());
+      exit(EXIT_FAILURE);
+    }
+    if (*end == 'K' || *end == 'k') {
+      number <<= 10;
+    } else if (*end == 'M' || *end == 'm') {
+      number <<= 20;
+    }
+    return number;
+  }
+
+private:
+  std::vector<std::pair<std::string, std::string>> values_;
+};
+
+/// One result, printed as a JSON object or a CSV row on a single line.
+class Record
+{
+public:
+  explicit Record(const char * benchmark)
+  {
+    add("benchmark", benchmark);
+    add("rmw", rmw_get_implementation_identifier());
+  }
+
+  Record &
+  add(const char * name, const std::string & value)
+  {
+    fields_.emplace_back(name, "\"" + value + "\"");
+    return *this;
+  }
+
+  Record &
+  add(const char * name, const char * value)
+  {
+    return add(name, std::string(value));
+  }
+
+  Record &
+  add(const char * name, uint64_t value)
+  {
+    fields_.emplace_back(name, std::to_string(value));
+    return *this;
+  }
+
+  Record &
+  add(const char * name, double value)
+  {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.3f", value);
+    fields_.emplace_back(name, buffer);
+    return *this;
+  }
+
+  /// Whether the CSV header was printed, to be set by processes forking one per run.
+  static bool &
+  csv_header_printed()
+  {
+    static bool printed = false;
+    return printed;
+  }
+
+  /// Print the record, preceded by the CSV header the first time.
+  void
+  print(const std::string & format) const
+  {
+    std::string line;
+    if (format == "csv") {
+      if (!csv_header_printed()) {
+        for (const auto & field : fields_) {
+          line += (line.empty() ? "" : ",") + field.first;
+        }
+        printf("%s\n", line.c_str());
+        line.clear();
+        csv_header_printed() = true;
+      }
+      for (const auto & field : fields_) {
+        line += (line.empty() ? "" : ",") + field.second;
+      }
+    } else {
+      for (const auto & field : fields_) {
+        line += (line.empty() ? "{" : ", ") + ("\"" + field.first + "\": ") + field.second;
+      }
+      line += "}";
+    }
+    printf("%s\n", line.c_str());
+    fflush(stdout);
+  }
+
+private:
+  std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+/// Add the mean and the percentiles of the samples, in nanoseconds, to a record.
+inline void
+add_percentiles(Record & record, const char * prefix, std::vector<int64_t> samples)
+{
+  std::string name(prefix);
+  if (samples.empty()) {
+    samples.push_back(0);
+  }
+  std::sort(samples.begin(), samples.end());
+  auto at = [&samples](double fraction) {
+      size_t index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+      return static_cast<uint64_t>(samples[index]);
+    };
+  double sum = 0;
+  for (auto sample : samples) {
+    sum += static_cast<double>(sample);
+  }
+  record.add((name + "_mean_ns").c_str(), sum / static_cast<double>(samples.size()));
+  record.add((name + "_p50_ns").c_str(), at(0.5));
+  record.add((name + "_p90_ns").c_str(), at(0.9));
+  record.add((name + "_p99_ns").c_str(), at(0.99));
+  record.add((name + "_p999_ns").c_str(), at(0.999));
+  record.add((name + "_max_ns").c_str(), at(1.0));
+}
+
+/// Context of the rmw implementation the benchmark is linked against.
+class Session
+{
+public:
+  Session()
+  : options_(rmw_get_zero_initialized_init_options()),
+    context_(rmw_get_zero_initialized_context())
+  {
+    check(rmw_init_options_init(&options_, rcutils_get_default_allocator()),
+      "rmw_init_options_init");
+    check(rmw_init(&options_, &context_), "rmw_init");
+  }
+
+  ~Session()
+  {
+    rmw_shutdown(&context_);
+    rmw_context_fini(&context_);
+    rmw_init_options_fini(&options_);
+  }
+
+  rmw_context_t *
+  context()
+  {
+    return &context_;
+  }
+
+  rmw_node_t *
+  create_node(const std::string & name, size_t domain_id = 0)
+  {
+    rmw_node_security_options_t security_options = rmw_get_default_node_security_options();
+    return check(
+      rmw_create_node(&context_, name.c_str(), "/benchmark", domain_id, &security_options),
+      "rmw_create_node");
+  }
+
+private:
+  rmw_init_options_t options_;
+  rmw_context_t context_;
+};
+
+inline rmw_qos_profile_t
+make_qos(const std::string & reliability, size_t depth)
+{
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  qos.depth = depth;
+  if (reliability == "best_effort") {
+    qos.reliability = RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT;
+  } else if (reliability == "reliable") {
+    qos.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+  } else {
+    fprintf(stderr, "unknown reliability '%s'\n", reliability.c_str());
+    exit(EXIT_FAILURE);
+  }
+  return qos;
+}
+
+}  // namespace benchmark
+
+#endif  // BENCHMARK_COMMON_HPP_
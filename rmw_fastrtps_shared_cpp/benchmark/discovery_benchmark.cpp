@@ -0,0 +1,213 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Time for participants to discover each other's endpoints, and what it costs in memory
+// and in the discovery callbacks, for N nodes of M endpoints each. Every node has its own
+// participant, so discovery runs as between processes, while all the nodes live in one
+// process to tell when every one of them has seen every endpoint. Each configuration runs
+// in a new process, so the peak resident memory is its own.
+//
+// Every node creates M / 2 publishers and M / 2 subscriptions, on topics shared by all
+// the nodes, and has converged once its topic caches count N publishers and N
+// subscriptions on each topic, its own included.
+//
+// Options, all optional:
+//   --participants=2,5,10,20
+//   --endpoints=2,10,50           per participant
+//   --timeout_s=60                after which a run is reported as not converged
+//   --format=json|csv
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "test_msgs/msg/empty.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+#include "./benchmark_common.hpp"
+
+namespace
+{
+
+int64_t
+system_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+struct Participant
+{
+  rmw_node_t * node;
+  std::vector<rmw_publisher_t *> publishers;
+  std::vector<rmw_subscription_t *> subscriptions;
+};
+
+bool
+has_converged(
+  const Participant & participant, const std::vector<std::string> & topics, size_t expected)
+{
+  for (const auto & topic : topics) {
+    size_t publishers = 0;
+    size_t subscriptions = 0;
+    benchmark::check(
+      rmw_count_publishers(participant.node, topic.c_str(), &publishers),
+      "rmw_count_publishers");
+    benchmark::check(
+      rmw_count_subscribers(participant.node, topic.c_str(), &subscriptions),
+      "rmw_count_subscribers");
+    if (publishers < expected || subscriptions < expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+measure(size_t participant_count, size_t endpoint_count, int64_t timeout_ns,
+  const std::string & format)
+{
+  benchmark::Session session;
+  auto type_support =
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Empty>();
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  std::vector<std::string> topics;
+  for (size_t i = 0; i < (endpoint_count + 1) / 2; ++i) {
+    topics.push_back("/discovery_benchmark_" + std::to_string(getpid()) + "_" + std::to_string(i));
+  }
+
+  int64_t start_ns = benchmark::now_ns();
+  int64_t start_system_ns = system_time_ns();
+  int64_t start_cpu_ns = benchmark::process_cpu_ns();
+  std::vector<Participant> participants(participant_count);
+  for (size_t i = 0; i < participant_count; ++i) {
+    auto & participant = participants[i];
+    participant.node = session.create_node("discovery_benchmark_" + std::to_string(i));
+    for (const auto & topic : topics) {
+      participant.publishers.push_back(benchmark::check(
+          rmw_create_publisher(participant.node, type_support, topic.c_str(), &qos),
+          "rmw_create_publisher"));
+      participant.subscriptions.push_back(benchmark::check(
+          rmw_create_subscription(participant.node, type_support, topic.c_str(), &qos, false),
+          "rmw_create_subscription"));
+    }
+  }
+  int64_t created_ns = benchmark::now_ns();
+
+  bool converged = false;
+  while (!converged && benchmark::now_ns() - start_ns < timeout_ns) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    converged = true;
+    for (const auto & participant : participants) {
+      if (!has_converged(participant, topics, participant_count)) {
+        converged = false;
+        break;
+      }
+    }
+  }
+  int64_t cpu_ns = benchmark::process_cpu_ns() - start_cpu_ns;
+
+  // The topic caches last changed when the last endpoint was discovered
+  rmw_fastrtps_shared_cpp::DiscoveryStatistics total = {};
+  int64_t last_change_ns = start_system_ns;
+  for (const auto & participant : participants) {
+    rmw_fastrtps_shared_cpp::DiscoveryStatistics statistics;
+    benchmark::check(
+      rmw_fastrtps_shared_cpp::__rmw_get_node_discovery_statistics(
+        rmw_get_implementation_identifier(), participant.node, &statistics),
+      "get_node_discovery_statistics");
+    total.participants_discovered += statistics.participants_discovered;
+    total.readers_discovered += statistics.readers_discovered;
+    total.writers_discovered += statistics.writers_discovered;
+    total.graph_triggers += statistics.graph_triggers;
+    total.callback_time_ns += statistics.callback_time_ns;
+    last_change_ns = std::max(last_change_ns, statistics.last_change_ns);
+  }
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  benchmark::Record record("discovery");
+  record.add("participants", static_cast<uint64_t>(participant_count))
+  .add("endpoints_per_participant", static_cast<uint64_t>(2 * topics.size()))
+  .add("converged", converged ? "true" : "false")
+  .add("creation_ms", static_cast<double>(created_ns - start_ns) / 1e6)
+  .add("convergence_ms", static_cast<double>(last_change_ns - start_system_ns) / 1e6)
+  .add("participants_discovered", total.participants_discovered)
+  .add("readers_discovered", total.readers_discovered)
+  .add("writers_discovered", total.writers_discovered)
+  .add("graph_triggers", total.graph_triggers)
+  .add("listener_callback_ms", static_cast<double>(total.callback_time_ns) / 1e6)
+  .add("process_cpu_ms", static_cast<double>(cpu_ns) / 1e6)
+  // Linux reports kilobytes
+  .add("peak_rss_bytes", static_cast<uint64_t>(usage.ru_maxrss) * 1024);
+  record.print(format);
+
+  for (auto & participant : participants) {
+    for (auto publisher : participant.publishers) {
+      rmw_destroy_publisher(participant.node, publisher);
+    }
+    for (auto subscription : participant.subscriptions) {
+      rmw_destroy_subscription(participant.node, subscription);
+    }
+    rmw_destroy_node(participant.node);
+  }
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+  std::string format = options.get("format", "json");
+  int64_t timeout_ns = static_cast<int64_t>(options.number("timeout_s", 60)) * 1000000000LL;
+  for (auto participant_count : options.numbers("participants", "2,5,10,20")) {
+    for (auto endpoint_count : options.numbers("endpoints", "2,10,50")) {
+      // The benchmark process never initializes rmw, so it can fork safely
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid == 0) {
+        measure(participant_count, endpoint_count, timeout_ns, format);
+        fflush(stdout);
+        _exit(EXIT_SUCCESS);
+      }
+      if (pid < 0) {
+        perror("fork");
+        return EXIT_FAILURE;
+      }
+      int status = 0;
+      waitpid(pid, &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        fprintf(stderr, "the run of %zu participants failed\n",
+          static_cast<size_t>(participant_count));
+        return EXIT_FAILURE;
+      }
+      benchmark::Record::csv_header_printed() = true;
+    }
+  }
+  return EXIT_SUCCESS;
+}
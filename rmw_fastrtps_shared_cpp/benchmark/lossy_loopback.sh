@@ -0,0 +1,94 @@
+#!/bin/bash
+# Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Recovery latency of reliable writers and readers on a lossy loopback interface.
+#
+# netem drops the given share of the packets sent on the loopback interface while the
+# pubsub_benchmark of an rmw implementation exchanges reliable messages between two
+# processes. Each loss is run with the default timings of the reliable writers and readers,
+# then with the tuned ones. A lost sample is only delivered once it was repaired, so the
+# recovery latency shows in the tail of the latency percentiles, and in the rate of the
+# burst, compared to the run without loss.
+#
+# Usage, as root since tc needs CAP_NET_ADMIN, from a shell where the workspace was sourced:
+#   lossy_loopback.sh <rmw_fastrtps_cpp|rmw_fastrtps_dynamic_cpp> [pubsub_benchmark options]
+# for instance
+#   sudo -E lossy_loopback.sh rmw_fastrtps_cpp --sizes=64,64K --depths=100
+#
+# Env variables, all optional:
+#   LOSS_PERCENTAGES="0 1 5 10"   shares of the packets dropped, one set of runs each
+#   TUNED_TIMINGS="HEARTBEAT_PERIOD_MS=10 ..."
+#                                 timings of the tuned runs, each given to the
+#                                 RMW_FASTRTPS_<name> env variable, by default a 10 ms
+#                                 heartbeat period and no response delays
+#   INTERFACE=lo                  interface the loss is applied to
+#
+# Every record of the benchmark is printed as a JSON object, with the loss_percent and the
+# timings ("default" or "tuned") of its run added. The loss is removed on exit.
+
+set -e -o pipefail
+
+if [ $# -lt 1 ]; then
+  sed -n '/^# Usage/,/^#   sudo/p' "$0" | sed 's/^# \{0,1\}//'
+  exit 1
+fi
+package="$1"
+shift
+
+LOSS_PERCENTAGES="${LOSS_PERCENTAGES:-0 1 5 10}"
+TUNED_TIMINGS="${TUNED_TIMINGS:-HEARTBEAT_PERIOD_MS=10 INITIAL_HEARTBEAT_DELAY_MS=0 \
+NACK_RESPONSE_DELAY_MS=0 HEARTBEAT_RESPONSE_DELAY_MS=0 INITIAL_ACKNACK_DELAY_MS=0}"
+INTERFACE="${INTERFACE:-lo}"
+timing_names="HEARTBEAT_PERIOD_MS INITIAL_HEARTBEAT_DELAY_MS NACK_RESPONSE_DELAY_MS \
+HEARTBEAT_RESPONSE_DELAY_MS INITIAL_ACKNACK_DELAY_MS"
+
+# the benchmark is installed by the rmw implementation, in one of the sourced prefixes
+benchmark=""
+IFS=':' read -r -a prefixes <<< "${AMENT_PREFIX_PATH}"
+for prefix in "${prefixes[@]}"; do
+  if [ -x "${prefix}/lib/${package}/pubsub_benchmark" ]; then
+    benchmark="${prefix}/lib/${package}/pubsub_benchmark"
+    break
+  fi
+done
+if [ -z "${benchmark}" ]; then
+  echo "pubsub_benchmark of ${package} not found in AMENT_PREFIX_PATH," \
+    "build it with -DBUILD_BENCHMARKS=ON" >&2
+  exit 1
+fi
+
+trap 'tc qdisc del dev "${INTERFACE}" root netem 2> /dev/null || true' EXIT
+
+for loss in ${LOSS_PERCENTAGES}; do
+  tc qdisc del dev "${INTERFACE}" root netem 2> /dev/null || true
+  if [ "${loss}" != "0" ]; then
+    tc qdisc add dev "${INTERFACE}" root netem loss "${loss}%"
+  fi
+  for timings in default tuned; do
+    for name in ${timing_names}; do
+      unset "RMW_FASTRTPS_${name}"
+    done
+    if [ "${timings}" = "tuned" ]; then
+      for timing in ${TUNED_TIMINGS}; do
+        export "RMW_FASTRTPS_${timing}"
+      done
+    fi
+    # a long timeout, so that slow repairs show in the latencies instead of as lost pings
+    # the first value given for an option is used, so those given on the command line win
+    "${benchmark}" --format=json "$@" \
+      --topologies=separate_processes --reliabilities=reliable --timeout_ms=10000 |
+      sed "s/^{/{\"loss_percent\": ${loss}, \"timings\": \"${timings}\", /"
+  done
+done
@@ -0,0 +1,415 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// How the memory footprint estimates compare with the resident memory they stand for.
+// Each configuration runs in a new process, which creates one entity of the kind to have
+// the types registered and the one-time allocations done, then creates N more and
+// compares the sum of their estimated footprints with the growth of its resident memory.
+// The ratio is expected below one, since the estimates leave out the allocator overhead
+// and the internals of Fast RTPS.
+//
+// The allocations made by all the threads of the process while the N entities are created
+// are counted as well, by interposing the allocation functions of glibc.
+//
+// The history memory policy of the entities is either the one the rmw implementation picks
+// for their type and depth, or one forced through a default XML profile written in the
+// working directory of the run, with RMW_FASTRTPS_USE_QOS_FROM_XML set. The XML profile
+// leaves the resource limits of the histories at the defaults of Fast RTPS.
+//
+// Options, all optional:
+//   --kinds=node,publisher,subscription,service,client
+//   --entities=10,100,1000
+//   --depths=1,10,100             history depth of the entities
+//   --policies=auto,preallocated,preallocated_with_realloc,dynamic_reserve
+//   --format=json|csv
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_cpp/service_type_support.hpp"
+#include "test_msgs/msg/primitives.hpp"
+#include "test_msgs/srv/primitives.hpp"
+
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+#include "./benchmark_common.hpp"
+
+namespace
+{
+std::atomic<bool> counting(false);
+std::atomic<uint64_t> allocations(0);
+std::atomic<uint64_t> allocated_bytes(0);
+
+void
+count_allocation(size_t size)
+{
+  if (counting.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+}  // namespace
+
+extern "C"
+{
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * pointer, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+
+void *
+malloc(size_t size)
+{
+  count_allocation(size);
+  return __libc_malloc(size);
+}
+
+void *
+calloc(size_t count, size_t size)
+{
+  count_allocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+void *
+realloc(void * pointer, size_t size)
+{
+  count_allocation(size);
+  return __libc_realloc(pointer, size);
+}
+
+void *
+memalign(size_t alignment, size_t size)
+{
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size)
+{
+  count_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void ** pointer, size_t alignment, size_t size)
+{
+  if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  count_allocation(size);
+  void * memory = __libc_memalign(alignment, size);
+  if (!memory && size != 0) {
+    return ENOMEM;
+  }
+  *pointer = memory;
+  return 0;
+}
+}  // extern "C"
+
+namespace
+{
+
+/// Value of the historyMemoryPolicy XML element of each policy which can be forced.
+const std::map<std::string, std::string> xml_memory_policies = {
+  {"preallocated", "PREALLOCATED"},
+  {"preallocated_with_realloc", "PREALLOCATED_WITH_REALLOC"},
+  {"dynamic_reserve", "DYNAMIC"},
+};
+
+/// Have the entities created afterwards by this process use the given history memory policy.
+/**
+ * Fast RTPS loads DEFAULT_FASTRTPS_PROFILES.xml from the working directory, so the
+ * profile is written in a new directory which the process moves to.
+ *
+ * \return the path of the profile, to be removed once the first node was created
+ */
+std::string
+force_memory_policy(const std::string & policy)
+{
+  auto xml_policy = xml_memory_policies.find(policy);
+  if (xml_policy == xml_memory_policies.end()) {
+    fprintf(stderr, "unknown policy '%s'\n", policy.c_str());
+    exit(EXIT_FAILURE);
+  }
+  char directory[] = "/tmp/memory_footprint_benchmark_XXXXXX";
+  if (!mkdtemp(directory) || chdir(directory) != 0) {
+    perror(directory);
+    exit(EXIT_FAILURE);
+  }
+  FILE * profiles = fopen("DEFAULT_FASTRTPS_PROFILES.xml", "w");
+  if (!profiles) {
+    perror("DEFAULT_FASTRTPS_PROFILES.xml");
+    exit(EXIT_FAILURE);
+  }
+  fprintf(profiles,
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+    "<profiles>\n"
+    "  <publisher profile_name=\"memory_footprint_publisher\" is_default_profile=\"true\">\n"
+    "    <historyMemoryPolicy>%s</historyMemoryPolicy>\n"
+    "  </publisher>\n"
+    "  <subscriber profile_name=\"memory_footprint_subscriber\" is_default_profile=\"true\">\n"
+    "    <historyMemoryPolicy>%s</historyMemoryPolicy>\n"
+    "  </subscriber>\n"
+    "</profiles>\n",
+    xml_policy->second.c_str(), xml_policy->second.c_str());
+  fclose(profiles);
+  std::string path = std::string(directory) + "/DEFAULT_FASTRTPS_PROFILES.xml";
+  setenv("FASTRTPS_DEFAULT_PROFILES_FILE", path.c_str(), 1);
+  setenv("RMW_FASTRTPS_USE_QOS_FROM_XML", "1", 1);
+  return path;
+}
+
+/// Return the resident memory of the process.
+uint64_t
+resident_bytes()
+{
+  FILE * statm = fopen("/proc/self/statm", "r");
+  if (!statm) {
+    perror("/proc/self/statm");
+    exit(EXIT_FAILURE);
+  }
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (fscanf(statm, "%" SCNu64 " %" SCNu64, &size, &resident) != 2) {
+    fprintf(stderr, "unexpected content of /proc/self/statm\n");
+    exit(EXIT_FAILURE);
+  }
+  fclose(statm);
+  return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+/// Entities of one kind, with the sum of their estimated footprints.
+class Entities
+{
+public:
+  Entities(benchmark::Session & session, const std::string & kind, size_t depth)
+  : session_(session), kind_(kind), node_(nullptr)
+  {
+    qos_ = benchmark::make_qos("reliable", depth);
+    if (kind_ != "node") {
+      node_ = session_.create_node("memory_footprint_benchmark");
+    }
+  }
+
+  ~Entities()
+  {
+    for (auto publisher : publishers_) {
+      rmw_destroy_publisher(node_, publisher);
+    }
+    for (auto subscription : subscriptions_) {
+      rmw_destroy_subscription(node_, subscription);
+    }
+    for (auto service : services_) {
+      rmw_destroy_service(node_, service);
+    }
+    for (auto client : clients_) {
+      rmw_destroy_client(node_, client);
+    }
+    for (auto node : nodes_) {
+      rmw_destroy_node(node);
+    }
+    if (node_) {
+      rmw_destroy_node(node_);
+    }
+  }
+
+  /// Create an entity on a topic or service of its own, and return its estimated footprint.
+  rmw_fastrtps_shared_cpp::MemoryFootprint
+  create()
+  {
+    auto message_type_support =
+      rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Primitives>();
+    auto service_type_support =
+      rosidl_typesupport_cpp::get_service_type_support_handle<test_msgs::srv::Primitives>();
+    std::string name = "/memory_footprint_benchmark_" + std::to_string(count_++);
+    rmw_fastrtps_shared_cpp::MemoryFootprint footprint = {};
+    if (kind_ == "node") {
+      nodes_.push_back(session_.create_node(
+          "memory_footprint_benchmark_" + std::to_string(nodes_.size())));
+      benchmark::check(
+        rmw_fastrtps_shared_cpp::__rmw_get_node_memory_footprint(
+          rmw_get_implementation_identifier(), nodes_.back(), &footprint),
+        "get_node_memory_footprint");
+    } else if (kind_ == "publisher") {
+      publishers_.push_back(benchmark::check(
+          rmw_create_publisher(node_, message_type_support, name.c_str(), &qos_),
+          "rmw_create_publisher"));
+      benchmark::check(
+        rmw_fastrtps_shared_cpp::__rmw_get_publisher_memory_footprint(
+          rmw_get_implementation_identifier(), publishers_.back(), &footprint),
+        "get_publisher_memory_footprint");
+    } else if (kind_ == "subscription") {
+      subscriptions_.push_back(benchmark::check(
+          rmw_create_subscription(node_, message_type_support, name.c_str(), &qos_, false),
+          "rmw_create_subscription"));
+      benchmark::check(
+        rmw_fastrtps_shared_cpp::__rmw_get_subscription_memory_footprint(
+          rmw_get_implementation_identifier(), subscriptions_.back(), &footprint),
+        "get_subscription_memory_footprint");
+    } else if (kind_ == "service") {
+      services_.push_back(benchmark::check(
+          rmw_create_service(node_, service_type_support, name.c_str(), &qos_),
+          "rmw_create_service"));
+      benchmark::check(
+        rmw_fastrtps_shared_cpp::__rmw_get_service_memory_footprint(
+          rmw_get_implementation_identifier(), services_.back(), &footprint),
+        "get_service_memory_footprint");
+    } else if (kind_ == "client") {
+      clients_.push_back(benchmark::check(
+          rmw_create_client(node_, service_type_support, name.c_str(), &qos_),
+          "rmw_create_client"));
+      benchmark::check(
+        rmw_fastrtps_shared_cpp::__rmw_get_client_memory_footprint(
+          rmw_get_implementation_identifier(), clients_.back(), &footprint),
+        "get_client_memory_footprint");
+    } else {
+      fprintf(stderr, "unknown kind '%s'\n", kind_.c_str());
+      exit(EXIT_FAILURE);
+    }
+    return footprint;
+  }
+
+private:
+  benchmark::Session & session_;
+  std::string kind_;
+  rmw_qos_profile_t qos_;
+  rmw_node_t * node_;
+  size_t count_ = 0;
+  std::vector<rmw_node_t *> nodes_;
+  std::vector<rmw_publisher_t *> publishers_;
+  std::vector<rmw_subscription_t *> subscriptions_;
+  std::vector<rmw_service_t *> services_;
+  std::vector<rmw_client_t *> clients_;
+};
+
+void
+measure(
+  const std::string & kind, size_t entity_count, size_t depth, const std::string & policy,
+  const std::string & format)
+{
+  std::string profile_path;
+  if (policy != "auto") {
+    profile_path = force_memory_policy(policy);
+  }
+  benchmark::Session session;
+  Entities entities(session, kind, depth);
+  entities.create();
+  if (!profile_path.empty()) {
+    // loaded with the first node
+    remove(profile_path.c_str());
+    rmdir(profile_path.substr(0, profile_path.rfind('/')).c_str());
+  }
+  // let the threads of Fast RTPS allocate their buffers before the baseline
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  uint64_t baseline_bytes = resident_bytes();
+  uint64_t entity_bytes = 0;
+  uint64_t history_bytes = 0;
+  uint64_t discovery_bytes = 0;
+  counting.store(true);
+  for (size_t i = 0; i < entity_count; ++i) {
+    auto footprint = entities.create();
+    entity_bytes += footprint.entity_bytes;
+    history_bytes += footprint.history_bytes;
+    discovery_bytes += footprint.discovery_bytes;
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  counting.store(false);
+  uint64_t resident_growth = resident_bytes();
+  resident_growth = resident_growth > baseline_bytes ? resident_growth - baseline_bytes : 0;
+  uint64_t estimated_bytes = entity_bytes + history_bytes + discovery_bytes;
+
+  benchmark::Record record("memory_footprint");
+  record.add("kind", kind)
+  .add("entities", static_cast<uint64_t>(entity_count))
+  .add("depth", static_cast<uint64_t>(depth))
+  .add("policy", policy)
+  .add("estimated_entity_bytes", entity_bytes)
+  .add("estimated_history_bytes", history_bytes)
+  .add("estimated_discovery_bytes", discovery_bytes)
+  .add("estimated_bytes", estimated_bytes)
+  .add("rss_growth_bytes", resident_growth)
+  .add("estimated_per_entity_bytes",
+    static_cast<double>(estimated_bytes) / static_cast<double>(entity_count))
+  .add("rss_growth_per_entity_bytes",
+    static_cast<double>(resident_growth) / static_cast<double>(entity_count))
+  .add("estimate_to_rss_ratio", resident_growth ?
+    static_cast<double>(estimated_bytes) / static_cast<double>(resident_growth) : 0.0)
+  .add("allocations", allocations.load())
+  .add("allocated_bytes", allocated_bytes.load())
+  .add("allocations_per_entity",
+    static_cast<double>(allocations.load()) / static_cast<double>(entity_count));
+  record.print(format);
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+  std::string format = options.get("format", "json");
+  for (const auto & kind : options.list("kinds", "node,publisher,subscription,service,client")) {
+    for (auto entity_count : options.numbers("entities", "10,100,1000")) {
+      for (auto depth : options.numbers("depths", "1,10,100")) {
+        for (const auto & policy : options.list("policies",
+          "auto,preallocated,preallocated_with_realloc,dynamic_reserve"))
+        {
+          // the policy only applies to the histories of the entities of the nodes
+          if (entity_count == 0 || (kind == "node" && policy != "auto")) {
+            continue;
+          }
+          // The benchmark process never initializes rmw, so it can fork safely
+          fflush(stdout);
+          pid_t pid = fork();
+          if (pid == 0) {
+            measure(kind, entity_count, depth, policy, format);
+            fflush(stdout);
+            _exit(EXIT_SUCCESS);
+          }
+          if (pid < 0) {
+            perror("fork");
+            return EXIT_FAILURE;
+          }
+          int status = 0;
+          waitpid(pid, &status, 0);
+          if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            fprintf(stderr, "the run of %zu %s entities failed\n",
+              static_cast<size_t>(entity_count), kind.c_str());
+            return EXIT_FAILURE;
+          }
+          benchmark::Record::csv_header_printed() = true;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
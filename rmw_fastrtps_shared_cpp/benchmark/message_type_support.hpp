@@ -0,0 +1,40 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MESSAGE_TYPE_SUPPORT_HPP_
+#define MESSAGE_TYPE_SUPPORT_HPP_
+
+#include <memory>
+
+#include "rosidl_generator_c/message_type_support_struct.h"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+namespace benchmark
+{
+
+/// Create the type support the endpoints of the rmw implementation use for a message type.
+/**
+ * Each rmw implementation defines it for its own type supports.
+ *
+ * \param[in] type_support handle of the message type, as given to rmw_create_publisher
+ * \return the type support, or null if the type has none this implementation handles
+ */
+std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport>
+create_message_type_support(const rosidl_message_type_support_t * type_support);
+
+}  // namespace benchmark
+
+#endif  // MESSAGE_TYPE_SUPPORT_HPP_
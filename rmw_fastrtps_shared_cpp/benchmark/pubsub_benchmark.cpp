@@ -0,0 +1,620 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Latency and throughput of a publisher and a subscription exchanging messages of
+// increasing sizes, with a peer in the same process or in a separate one, for each
+// reliability, history depth and way of receiving the messages.
+//
+// With --mode=head_of_line, the latency is instead measured on small bounded messages
+// while a bulk publisher of the same process sends messages of the given sizes back to back
+// to the peer, once with the ping and pong topics in RMW_FASTRTPS_HIGH_PRIORITY_TOPICS and
+// once without. The bulk messages are unbounded, so they go through the asynchronous writer
+// thread; with the high priority lane, the small messages are written synchronously instead
+// of queueing behind their fragments.
+//
+// Options, all optional:
+//   --mode=ping_pong|head_of_line
+//   --topologies=same_process,separate_processes
+//   --reliabilities=best_effort,reliable
+//   --depths=1,100
+//   --receives=wait_set,take      block in rmw_wait before taking, or poll rmw_take
+//   --sizes=64,1K,...,8M          payload bytes, of the bulk messages in head of line mode
+//   --samples=1000                pings measured and pongs sent in a burst per run
+//   --max_bytes=256M              fewer samples for larger payloads, at least 10
+//   --timeout_ms=1000             after which a ping or the rest of a burst is lost
+//   --throughput_limits=none      bandwidth limit set for each run, one of
+//                                 none, publisher:<bytes>/<period_ms> or
+//                                 participant:<bytes>/<period_ms>, not in head of line mode
+//   --lanes=off,on                whether the high priority lane is used, in head of line mode
+//   --format=json|csv
+//
+// A throughput limit is given to the nodes of both sides through the
+// RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT or RMW_FASTRTPS_PARTICIPANT_THROUGHPUT_LIMIT
+// env variable. It only applies to asynchronous writers, so the messages of this benchmark,
+// which are unbounded, always see it; compare the bytes_per_s of the burst, which is
+// the observed rate, to the limit_bytes_per_s of the record.
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "test_msgs/msg/builtins.hpp"
+#include "test_msgs/msg/dynamic_array_primitives.hpp"
+
+#include "./benchmark_common.hpp"
+
+namespace
+{
+
+using Message = test_msgs::msg::DynamicArrayPrimitives;
+// Bounded, as the writers of unbounded types cannot use the high priority lane
+using PriorityMessage = test_msgs::msg::Builtins;
+
+// The payload starts with the sequence number of the sample, followed by the command
+// of a ping: echo it, stop, or send back that many pongs as fast as possible.
+constexpr size_t sequence_offset = 0;
+constexpr size_t command_offset = 8;
+constexpr size_t min_payload_bytes = 16;
+constexpr uint64_t echo_command = 0;
+constexpr uint64_t stop_command = UINT64_MAX;
+// A peer gives up once nothing was received for that long
+constexpr int64_t peer_idle_timeout_ns = 30000000000LL;
+
+struct Run
+{
+  std::string topology;
+  std::string reliability;
+  size_t depth;
+  std::string receive;
+  size_t payload_bytes;
+  size_t samples;
+  int64_t timeout_ns;
+  std::string throughput_limit;
+  std::string lane;
+  std::string ping_topic;
+  std::string pong_topic;
+  // Topic of the bulk messages of the head of line mode, empty in the other mode
+  std::string bulk_topic;
+};
+
+void
+write_word(Message & message, size_t offset, uint64_t value)
+{
+  memcpy(&message.byte_values[offset], &value, sizeof(value));
+}
+
+uint64_t
+read_word(const Message & message, size_t offset)
+{
+  uint64_t value = stop_command;
+  if (message.byte_values.size() >= offset + sizeof(value)) {
+    memcpy(&value, &message.byte_values[offset], sizeof(value));
+  }
+  return value;
+}
+
+void
+resize_payload(Message & message, size_t payload_bytes)
+{
+  message.byte_values.resize(payload_bytes);
+}
+
+// The words of a priority message are carried by its time, for the sequence number,
+// and by its duration, for the command.
+template<typename Stamp>
+void
+write_stamp(Stamp & stamp, uint64_t value)
+{
+  stamp.sec = static_cast<int32_t>(static_cast<uint32_t>(value >> 32));
+  stamp.nanosec = static_cast<uint32_t>(value);
+}
+
+template<typename Stamp>
+uint64_t
+read_stamp(const Stamp & stamp)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(stamp.sec)) << 32) | stamp.nanosec;
+}
+
+void
+write_word(PriorityMessage & message, size_t offset, uint64_t value)
+{
+  if (offset == sequence_offset) {
+    write_stamp(message.time_value, value);
+  } else {
+    write_stamp(message.duration_value, value);
+  }
+}
+
+uint64_t
+read_word(const PriorityMessage & message, size_t offset)
+{
+  return offset == sequence_offset ?
+         read_stamp(message.time_value) : read_stamp(message.duration_value);
+}
+
+void
+resize_payload(PriorityMessage &, size_t)
+{
+}
+
+/// Set the env variable of the throughput limit read by the nodes created afterwards.
+/**
+ * \return the limit in bytes per second, or zero if there is none
+ */
+double
+set_throughput_limit(const std::string & limit)
+{
+  unsetenv("RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT");
+  unsetenv("RMW_FASTRTPS_PARTICIPANT_THROUGHPUT_LIMIT");
+  if (limit == "none") {
+    return 0.0;
+  }
+  size_t colon = limit.find(':');
+  std::string scope = limit.substr(0, colon);
+  unsigned long bytes_per_period = 0;  // NOLINT(runtime/int)
+  unsigned long period_ms = 0;  // NOLINT(runtime/int)
+  char trailing = '\0';
+  if (
+    colon == std::string::npos || (scope != "publisher" && scope != "participant") ||
+    sscanf(
+      limit.c_str() + colon + 1, "%lu/%lu%c", &bytes_per_period, &period_ms, &trailing) != 2 ||
+    bytes_per_period == 0 || period_ms == 0)
+  {
+    fprintf(stderr, "invalid throughput limit '%s'\n", limit.c_str());
+    exit(EXIT_FAILURE);
+  }
+  const char * env_var = scope == "publisher" ?
+    "RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT" : "RMW_FASTRTPS_PARTICIPANT_THROUGHPUT_LIMIT";
+  setenv(env_var, limit.c_str() + colon + 1, 1);
+  return static_cast<double>(bytes_per_period) * 1000.0 / static_cast<double>(period_ms);
+}
+
+template<typename MessageT>
+class Endpoints
+{
+public:
+  Endpoints(
+    benchmark::Session & session, const Run & run, const char * role,
+    const std::string & publish_topic, const std::string & subscribe_topic)
+  : receive_(run.receive)
+  {
+    node_ = session.create_node(std::string(role) + "_" + std::to_string(getpid()));
+    auto type_support = rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+    rmw_qos_profile_t qos = benchmark::make_qos(run.reliability, run.depth);
+    publisher_ = benchmark::check(
+      rmw_create_publisher(node_, type_support, publish_topic.c_str(), &qos),
+      "rmw_create_publisher");
+    subscription_ = benchmark::check(
+      rmw_create_subscription(node_, type_support, subscribe_topic.c_str(), &qos, true),
+      "rmw_create_subscription");
+    wait_set_ = benchmark::check(
+      rmw_create_wait_set(session.context(), 1), "rmw_create_wait_set");
+  }
+
+  ~Endpoints()
+  {
+    rmw_destroy_wait_set(wait_set_);
+    rmw_destroy_subscription(node_, subscription_);
+    rmw_destroy_publisher(node_, publisher_);
+    rmw_destroy_node(node_);
+  }
+
+  void
+  publish(const MessageT & message)
+  {
+    benchmark::check(rmw_publish(publisher_, &message), "rmw_publish");
+  }
+
+  /// Take the next message, received until the deadline at the latest.
+  bool
+  receive(MessageT & message, int64_t deadline_ns)
+  {
+    while (true) {
+      bool taken = false;
+      if (receive_ == "wait_set") {
+        int64_t remaining_ns = std::max<int64_t>(deadline_ns - benchmark::now_ns(), 0);
+        void * subscribers[] = {subscription_->data};
+        rmw_subscriptions_t subscriptions = {1, subscribers};
+        rmw_time_t timeout = {
+          static_cast<uint64_t>(remaining_ns / 1000000000),
+          static_cast<uint64_t>(remaining_ns % 1000000000)};
+        rmw_ret_t ret = rmw_wait(&subscriptions, nullptr, nullptr, nullptr, wait_set_, &timeout);
+        if (ret == RMW_RET_TIMEOUT) {
+          return false;
+        }
+        benchmark::check(ret, "rmw_wait");
+      }
+      benchmark::check(rmw_take(subscription_, &message, &taken), "rmw_take");
+      if (taken) {
+        return true;
+      }
+      if (benchmark::now_ns() >= deadline_ns) {
+        return false;
+      }
+    }
+  }
+
+private:
+  std::string receive_;
+  rmw_node_t * node_;
+  rmw_publisher_t * publisher_;
+  rmw_subscription_t * subscription_;
+  rmw_wait_set_t * wait_set_;
+};
+
+/// Answer the pings until told to stop, or until none came for a while.
+template<typename MessageT>
+void
+answer_pings(benchmark::Session & session, const Run & run)
+{
+  Endpoints<MessageT> endpoints(session, run, "pubsub_peer", run.pong_topic, run.ping_topic);
+  MessageT ping;
+  MessageT pong;
+  resize_payload(pong, run.payload_bytes);
+  while (endpoints.receive(ping, benchmark::now_ns() + peer_idle_timeout_ns)) {
+    uint64_t command = read_word(ping, command_offset);
+    if (command == stop_command) {
+      break;
+    }
+    if (command == echo_command) {
+      endpoints.publish(ping);
+      continue;
+    }
+    for (uint64_t sequence = 0; sequence < command; ++sequence) {
+      write_word(pong, sequence_offset, sequence);
+      endpoints.publish(pong);
+    }
+  }
+}
+
+void
+run_peer(Run run)
+{
+  benchmark::Session session;
+  if (run.bulk_topic.empty()) {
+    answer_pings<Message>(session, run);
+    return;
+  }
+  // The bulk messages are never taken, they only have to be sent to a subscription
+  rmw_node_t * node = session.create_node("pubsub_bulk_peer_" + std::to_string(getpid()));
+  rmw_qos_profile_t qos = benchmark::make_qos(run.reliability, run.depth);
+  rmw_subscription_t * subscription = benchmark::check(
+    rmw_create_subscription(
+      node, rosidl_typesupport_cpp::get_message_type_support_handle<Message>(),
+      run.bulk_topic.c_str(), &qos, false),
+    "rmw_create_subscription");
+  answer_pings<PriorityMessage>(session, run);
+  rmw_destroy_subscription(node, subscription);
+  rmw_destroy_node(node);
+}
+
+/// Send a ping and wait for its echo, skipping the late echoes of previous pings.
+template<typename MessageT>
+bool
+ping(
+  Endpoints<MessageT> & endpoints, MessageT & ping, MessageT & pong, uint64_t sequence,
+  int64_t timeout_ns)
+{
+  write_word(ping, sequence_offset, sequence);
+  write_word(ping, command_offset, echo_command);
+  int64_t deadline_ns = benchmark::now_ns() + timeout_ns;
+  endpoints.publish(ping);
+  while (endpoints.receive(pong, deadline_ns)) {
+    if (read_word(pong, sequence_offset) == sequence) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Wait for the peer to answer, then warm up, and return the last sequence number sent.
+template<typename MessageT>
+uint64_t
+start_pings(const Run & run, Endpoints<MessageT> & endpoints, MessageT & ping_message)
+{
+  MessageT pong_message;
+  uint64_t sequence = 0;
+  // Discovery has completed both ways once the peer answers
+  int64_t discovery_deadline_ns = benchmark::now_ns() + peer_idle_timeout_ns;
+  while (!ping(endpoints, ping_message, pong_message, ++sequence, 100000000LL)) {
+    if (benchmark::now_ns() > discovery_deadline_ns) {
+      fprintf(stderr, "the peer did not answer\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  for (int warm_up = 0; warm_up < 10; ++warm_up) {
+    ping(endpoints, ping_message, pong_message, ++sequence, run.timeout_ns);
+  }
+  return sequence;
+}
+
+/// Half the round trip of pings sent one at a time.
+template<typename MessageT>
+std::vector<int64_t>
+measure_latencies(
+  const Run & run, Endpoints<MessageT> & endpoints, MessageT & ping_message, uint64_t & sequence)
+{
+  MessageT pong_message;
+  std::vector<int64_t> latencies;
+  latencies.reserve(run.samples);
+  for (size_t i = 0; i < run.samples; ++i) {
+    int64_t start_ns = benchmark::now_ns();
+    if (ping(endpoints, ping_message, pong_message, ++sequence, run.timeout_ns)) {
+      latencies.push_back((benchmark::now_ns() - start_ns) / 2);
+    }
+  }
+  return latencies;
+}
+
+template<typename MessageT>
+void
+stop_peer(Endpoints<MessageT> & endpoints, MessageT & ping_message)
+{
+  write_word(ping_message, command_offset, stop_command);
+  for (int i = 0; i < 3; ++i) {
+    endpoints.publish(ping_message);
+  }
+}
+
+void
+measure(const Run & run, double limit_bytes_per_s, const std::string & format)
+{
+  benchmark::Session session;
+  Endpoints<Message> endpoints(session, run, "pubsub", run.ping_topic, run.pong_topic);
+  Message ping_message;
+  Message pong_message;
+  ping_message.byte_values.resize(run.payload_bytes);
+  uint64_t sequence = start_pings(run, endpoints, ping_message);
+  std::vector<int64_t> latencies = measure_latencies(run, endpoints, ping_message, sequence);
+
+  // Pongs sent back to back after a single ping
+  write_word(ping_message, command_offset, run.samples);
+  int64_t burst_start_ns = benchmark::now_ns();
+  endpoints.publish(ping_message);
+  size_t received = 0;
+  int64_t last_reception_ns = burst_start_ns;
+  while (received < run.samples &&
+    endpoints.receive(pong_message, benchmark::now_ns() + run.timeout_ns))
+  {
+    ++received;
+    last_reception_ns = benchmark::now_ns();
+  }
+  double burst_s = static_cast<double>(last_reception_ns - burst_start_ns) / 1e9;
+  stop_peer(endpoints, ping_message);
+
+  benchmark::Record record("pubsub");
+  record.add("topology", run.topology)
+  .add("reliability", run.reliability)
+  .add("depth", static_cast<uint64_t>(run.depth))
+  .add("receive", run.receive)
+  .add("payload_bytes", static_cast<uint64_t>(run.payload_bytes))
+  .add("samples", static_cast<uint64_t>(run.samples))
+  .add("lost_pings", static_cast<uint64_t>(run.samples - latencies.size()));
+  benchmark::add_percentiles(record, "latency", latencies);
+  record.add("burst_received", static_cast<uint64_t>(received))
+  .add("messages_per_s", burst_s > 0 ? static_cast<double>(received) / burst_s : 0.0)
+  .add("bytes_per_s", burst_s > 0 ?
+    static_cast<double>(received * run.payload_bytes) / burst_s : 0.0)
+  .add("throughput_limit", run.throughput_limit)
+  .add("limit_bytes_per_s", limit_bytes_per_s);
+  record.print(format);
+}
+
+/// Latency of small messages while a publisher of the same process sends bulk messages.
+void
+measure_head_of_line(const Run & run, const std::string & format)
+{
+  benchmark::Session session;
+  Endpoints<PriorityMessage> endpoints(
+    session, run, "pubsub_priority", run.ping_topic, run.pong_topic);
+  rmw_node_t * bulk_node = session.create_node("pubsub_bulk_" + std::to_string(getpid()));
+  rmw_qos_profile_t qos = benchmark::make_qos(run.reliability, run.depth);
+  rmw_publisher_t * bulk_publisher = benchmark::check(
+    rmw_create_publisher(
+      bulk_node, rosidl_typesupport_cpp::get_message_type_support_handle<Message>(),
+      run.bulk_topic.c_str(), &qos),
+    "rmw_create_publisher");
+  PriorityMessage ping_message;
+  uint64_t sequence = start_pings(run, endpoints, ping_message);
+
+  // Nothing is sent before the bulk subscription of the peer was discovered
+  int64_t discovery_deadline_ns = benchmark::now_ns() + peer_idle_timeout_ns;
+  size_t subscribers = 0;
+  while (subscribers == 0) {
+    benchmark::check(
+      rmw_count_subscribers(bulk_node, run.bulk_topic.c_str(), &subscribers),
+      "rmw_count_subscribers");
+    if (subscribers == 0 && benchmark::now_ns() > discovery_deadline_ns) {
+      fprintf(stderr, "the peer did not subscribe to the bulk messages\n");
+      exit(EXIT_FAILURE);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::atomic<bool> stop(false);
+  uint64_t bulk_published = 0;
+  int64_t bulk_start_ns = benchmark::now_ns();
+  std::thread bulk([&run, &stop, &bulk_published, bulk_publisher]() {
+      Message bulk_message;
+      bulk_message.byte_values.resize(run.payload_bytes);
+      while (!stop.load()) {
+        benchmark::check(rmw_publish(bulk_publisher, &bulk_message), "rmw_publish");
+        ++bulk_published;
+      }
+    });
+  std::vector<int64_t> latencies = measure_latencies(run, endpoints, ping_message, sequence);
+  stop.store(true);
+  bulk.join();
+  double bulk_s = static_cast<double>(benchmark::now_ns() - bulk_start_ns) / 1e9;
+  stop_peer(endpoints, ping_message);
+  rmw_destroy_publisher(bulk_node, bulk_publisher);
+  rmw_destroy_node(bulk_node);
+
+  benchmark::Record record("pubsub_head_of_line");
+  record.add("topology", run.topology)
+  .add("reliability", run.reliability)
+  .add("depth", static_cast<uint64_t>(run.depth))
+  .add("receive", run.receive)
+  .add("lane", run.lane)
+  .add("bulk_bytes", static_cast<uint64_t>(run.payload_bytes))
+  .add("samples", static_cast<uint64_t>(run.samples))
+  .add("lost_pings", static_cast<uint64_t>(run.samples - latencies.size()));
+  benchmark::add_percentiles(record, "latency", latencies);
+  record.add("bulk_messages_per_s", static_cast<double>(bulk_published) / bulk_s);
+  record.print(format);
+}
+
+/// Run the peer in a new process of this executable.
+pid_t
+spawn_peer(const char * executable, const Run & run)
+{
+  std::vector<std::string> arguments = {
+    executable,
+    "--role=peer",
+    "--reliabilities=" + run.reliability,
+    "--depths=" + std::to_string(run.depth),
+    "--receives=" + run.receive,
+    "--sizes=" + std::to_string(run.payload_bytes),
+    "--ping_topic=" + run.ping_topic,
+    "--pong_topic=" + run.pong_topic,
+    "--bulk_topic=" + run.bulk_topic,
+  };
+  pid_t pid = fork();
+  if (pid == 0) {
+    std::vector<char *> argv;
+    for (auto & argument : arguments) {
+      argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+    execvp(executable, argv.data());
+    perror("execvp");
+    _exit(EXIT_FAILURE);
+  }
+  if (pid < 0) {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  return pid;
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+
+  if (options.get("role", "") == "peer") {
+    Run run;
+    run.reliability = options.get("reliabilities", "");
+    run.depth = options.number("depths", 1);
+    run.receive = options.get("receives", "");
+    run.payload_bytes = options.number("sizes", min_payload_bytes);
+    run.ping_topic = options.get("ping_topic", "");
+    run.pong_topic = options.get("pong_topic", "");
+    run.bulk_topic = options.get("bulk_topic", "");
+    run_peer(run);
+    return EXIT_SUCCESS;
+  }
+
+  std::string format = options.get("format", "json");
+  std::string mode = options.get("mode", "ping_pong");
+  if (mode != "ping_pong" && mode != "head_of_line") {
+    fprintf(stderr, "unknown mode '%s'\n", mode.c_str());
+    return EXIT_FAILURE;
+  }
+  bool head_of_line = mode == "head_of_line";
+  uint64_t samples = options.number("samples", 1000);
+  uint64_t max_bytes = options.number("max_bytes", 256ULL << 20);
+  int64_t timeout_ns = static_cast<int64_t>(options.number("timeout_ms", 1000)) * 1000000LL;
+  size_t run_index = 0;
+  for (const auto & topology : options.list("topologies", "same_process,separate_processes")) {
+    for (const auto & reliability : options.list("reliabilities", "best_effort,reliable")) {
+      for (auto depth : options.numbers("depths", "1,100")) {
+        for (const auto & receive : options.list("receives", "wait_set,take")) {
+          for (auto size : options.numbers("sizes", "64,256,1K,4K,16K,64K,256K,1M,4M,8M")) {
+            // the lanes vary in head of line mode, the throughput limits in the other one
+            for (const auto & variant : head_of_line ?
+              options.list("lanes", "off,on") : options.list("throughput_limits", "none"))
+            {
+              Run run;
+              run.topology = topology;
+              run.reliability = reliability;
+              run.depth = depth;
+              run.receive = receive;
+              run.payload_bytes = std::max<size_t>(size, min_payload_bytes);
+              run.samples = head_of_line ? samples : std::max<size_t>(
+                std::min<uint64_t>(samples, max_bytes / run.payload_bytes), 10);
+              run.timeout_ns = timeout_ns;
+              run.throughput_limit = head_of_line ? "none" : variant;
+              run.lane = head_of_line ? variant : "off";
+              std::string suffix = std::to_string(getpid()) + "_" + std::to_string(run_index++);
+              run.ping_topic = "benchmark_ping_" + suffix;
+              run.pong_topic = "benchmark_pong_" + suffix;
+              if (head_of_line) {
+                run.bulk_topic = "benchmark_bulk_" + suffix;
+              }
+              // inherited by the peer, whether a thread or a child process
+              double limit_bytes_per_s = set_throughput_limit(run.throughput_limit);
+              if (run.lane == "on") {
+                setenv(
+                  "RMW_FASTRTPS_HIGH_PRIORITY_TOPICS",
+                  (run.ping_topic + "," + run.pong_topic).c_str(), 1);
+              } else if (run.lane == "off") {
+                unsetenv("RMW_FASTRTPS_HIGH_PRIORITY_TOPICS");
+              } else {
+                fprintf(stderr, "unknown lane '%s'\n", run.lane.c_str());
+                return EXIT_FAILURE;
+              }
+              auto measure_run = [&run, head_of_line, limit_bytes_per_s, &format]() {
+                  if (head_of_line) {
+                    measure_head_of_line(run, format);
+                  } else {
+                    measure(run, limit_bytes_per_s, format);
+                  }
+                };
+
+              if (topology == "same_process") {
+                std::thread peer(run_peer, run);
+                measure_run();
+                peer.join();
+              } else if (topology == "separate_processes") {
+                pid_t peer = spawn_peer(argv[0], run);
+                measure_run();
+                waitpid(peer, nullptr, 0);
+              } else {
+                fprintf(stderr, "unknown topology '%s'\n", topology.c_str());
+                return EXIT_FAILURE;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Cost of serializing and deserializing messages of various shapes, with the C and the C++
+// type supports of the rmw implementation the benchmark is linked against.
+// The type supports are called the way a publisher and a subscription call them, into a
+// payload sized once, so neither the lookup of the type support nor the allocation of the
+// buffer is measured. The C messages are filled by deserializing the CDR of the equivalent
+// C++ messages.
+//
+// Options, all optional:
+//   --typesupports=c,cpp
+//   --shapes=flat_primitives,fixed_arrays,byte_sequence,many_strings,nested_sequences,empty
+//   --sizes=64,4K,1M              bytes of the byte sequences
+//   --strings=1000                strings of 16 characters in the many strings shape
+//   --nested=100                  elements of the nested sequences, each holding sequences
+//   --min_time_ms=500             of each measurement
+//   --format=json|csv
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rmw/serialized_message.h"
+
+#include "rosidl_generator_c/message_type_support_struct.h"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "test_msgs/msg/dynamic_array_primitives.h"
+#include "test_msgs/msg/dynamic_array_primitives.hpp"
+#include "test_msgs/msg/dynamic_array_primitives_nested.h"
+#include "test_msgs/msg/dynamic_array_primitives_nested.hpp"
+#include "test_msgs/msg/empty.h"
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/msg/primitives.h"
+#include "test_msgs/msg/primitives.hpp"
+#include "test_msgs/msg/static_array_primitives.h"
+#include "test_msgs/msg/static_array_primitives.hpp"
+
+#include "fastrtps/rtps/common/SerializedPayload.h"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+#include "./benchmark_common.hpp"
+#include "./message_type_support.hpp"
+
+namespace
+{
+
+/// Message to serialize and message to deserialize into, of the same type.
+struct Messages
+{
+  const rosidl_message_type_support_t * type_support;
+  void * input;
+  void * output;
+  std::function<void(void *)> destroy;
+};
+
+template<typename CppMessage>
+Messages
+cpp_messages(const CppMessage & message)
+{
+  return Messages {
+    rosidl_typesupport_cpp::get_message_type_support_handle<CppMessage>(),
+    new CppMessage(message),
+    new CppMessage(),
+    [](void * message) {delete static_cast<CppMessage *>(message);}};
+}
+
+// The generated C functions differ by the name of the message only
+#define C_MESSAGES(Type, message) \
+  c_messages( \
+    message, \
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Type), \
+    []() -> void * {return test_msgs__msg__ ## Type ## __create();}, \
+    [](void * message) { \
+      test_msgs__msg__ ## Type ## __destroy(static_cast<test_msgs__msg__ ## Type *>(message)); \
+    })
+
+template<typename CppMessage>
+Messages
+c_messages(
+  const CppMessage & message,
+  const rosidl_message_type_support_t * type_support,
+  void * (*create)(),
+  void (* destroy)(void *))
+{
+  Messages messages {type_support, create(), create(), destroy};
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t serialized = rmw_get_zero_initialized_serialized_message();
+  benchmark::check(rmw_serialized_message_init(&serialized, 0, &allocator),
+    "rmw_serialized_message_init");
+  benchmark::check(
+    rmw_serialize(
+      &message, rosidl_typesupport_cpp::get_message_type_support_handle<CppMessage>(),
+      &serialized),
+    "rmw_serialize");
+  benchmark::check(rmw_deserialize(&serialized, type_support, messages.input),
+    "rmw_deserialize");
+  rmw_serialized_message_fini(&serialized);
+  return messages;
+}
+
+template<typename CppMessage>
+Messages
+make_messages(const std::string & typesupport, const CppMessage & message);
+
+#define MAKE_MESSAGES(Type) \
+  template<> \
+  Messages \
+  make_messages(const std::string & typesupport, const test_msgs::msg::Type & message) \
+  { \
+    return typesupport == "c" ? C_MESSAGES(Type, message) : cpp_messages(message); \
+  }
+
+MAKE_MESSAGES(DynamicArrayPrimitives)
+MAKE_MESSAGES(DynamicArrayPrimitivesNested)
+MAKE_MESSAGES(Empty)
+MAKE_MESSAGES(Primitives)
+MAKE_MESSAGES(StaticArrayPrimitives)
+
+/// Call the function in batches of doubling size until one lasted the minimum time.
+template<typename Function>
+double
+ns_per_call(Function function, int64_t min_time_ns)
+{
+  for (uint64_t batch = 1;; batch *= 2) {
+    int64_t start_ns = benchmark::now_ns();
+    for (uint64_t i = 0; i < batch; ++i) {
+      function();
+    }
+    int64_t elapsed_ns = benchmark::now_ns() - start_ns;
+    if (elapsed_ns >= min_time_ns) {
+      return static_cast<double>(elapsed_ns) / static_cast<double>(batch);
+    }
+  }
+}
+
+void
+measure(
+  const std::string & typesupport, const std::string & shape, uint64_t elements,
+  const Messages & messages, int64_t min_time_ns, const std::string & format)
+{
+  std::unique_ptr<rmw_fastrtps_shared_cpp::TypeSupport> type_support =
+    benchmark::create_message_type_support(messages.type_support);
+  if (!type_support) {
+    fprintf(stderr, "no %s type support of the rmw implementation\n", typesupport.c_str());
+    exit(EXIT_FAILURE);
+  }
+  eprosima::fastrtps::rtps::SerializedPayload_t payload(
+    static_cast<uint32_t>(type_support->getEstimatedSerializedSize(messages.input)));
+  rmw_fastrtps_shared_cpp::SerializedData input {false, messages.input, false, 0, 0};
+  rmw_fastrtps_shared_cpp::SerializedData output {false, messages.output, false, 0, 0};
+
+  double serialize_ns = ns_per_call(
+    [&type_support, &input, &payload]() {
+      if (!type_support->serialize(&input, &payload)) {
+        fprintf(stderr, "serialize failed\n");
+        exit(EXIT_FAILURE);
+      }
+    }, min_time_ns);
+  double deserialize_ns = ns_per_call(
+    [&type_support, &output, &payload]() {
+      if (!type_support->deserialize(&payload, &output)) {
+        fprintf(stderr, "deserialize failed\n");
+        exit(EXIT_FAILURE);
+      }
+    }, min_time_ns);
+
+  double bytes = static_cast<double>(payload.length);
+  benchmark::Record record("serialization");
+  record.add("typesupport", typesupport)
+  .add("shape", shape)
+  .add("elements", elements)
+  .add("serialized_bytes", static_cast<uint64_t>(payload.length))
+  .add("serialize_ns_per_message", serialize_ns)
+  .add("serialize_bytes_per_s", bytes * 1e9 / serialize_ns)
+  .add("deserialize_ns_per_message", deserialize_ns)
+  .add("deserialize_bytes_per_s", bytes * 1e9 / deserialize_ns);
+  record.print(format);
+
+  messages.destroy(messages.input);
+  messages.destroy(messages.output);
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+  std::string format = options.get("format", "json");
+  int64_t min_time_ns = static_cast<int64_t>(options.number("min_time_ms", 500)) * 1000000LL;
+  uint64_t strings = options.number("strings", 1000);
+  uint64_t nested = options.number("nested", 100);
+
+  for (const auto & typesupport : options.list("typesupports", "c,cpp")) {
+    if (typesupport != "c" && typesupport != "cpp") {
+      fprintf(stderr, "unknown type support '%s'\n", typesupport.c_str());
+      return EXIT_FAILURE;
+    }
+    for (const auto & shape : options.list("shapes",
+      "flat_primitives,fixed_arrays,byte_sequence,many_strings,nested_sequences,empty"))
+    {
+      if (shape == "flat_primitives") {
+        test_msgs::msg::Primitives message;
+        message.bool_value = true;
+        message.int32_value = 42;
+        message.float64_value = 1.5;
+        message.string_value = "flat primitives";
+        measure(typesupport, shape, 1, make_messages(typesupport, message), min_time_ns, format);
+      } else if (shape == "fixed_arrays") {
+        test_msgs::msg::StaticArrayPrimitives message;
+        measure(typesupport, shape, 1, make_messages(typesupport, message), min_time_ns, format);
+      } else if (shape == "byte_sequence") {
+        for (auto size : options.numbers("sizes", "64,4K,1M")) {
+          test_msgs::msg::DynamicArrayPrimitives message;
+          message.byte_values.resize(size, 0x5a);
+          measure(
+            typesupport, shape, size, make_messages(typesupport, message), min_time_ns, format);
+        }
+      } else if (shape == "many_strings") {
+        test_msgs::msg::DynamicArrayPrimitives message;
+        message.string_values.resize(strings, std::string(16, 's'));
+        measure(
+          typesupport, shape, strings, make_messages(typesupport, message), min_time_ns, format);
+      } else if (shape == "nested_sequences") {
+        test_msgs::msg::DynamicArrayPrimitivesNested message;
+        message.dynamic_array_primitive_values.resize(nested);
+        for (auto & element : message.dynamic_array_primitive_values) {
+          element.int32_values.resize(16, 42);
+          element.string_values.resize(4, std::string(16, 's'));
+        }
+        measure(
+          typesupport, shape, nested, make_messages(typesupport, message), min_time_ns, format);
+      } else if (shape == "empty") {
+        test_msgs::msg::Empty message;
+        measure(typesupport, shape, 0, make_messages(typesupport, message), min_time_ns, format);
+      } else {
+        fprintf(stderr, "unknown shape '%s'\n", shape.c_str());
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Round trip latency and throughput of a service called by several clients at once.
+// Each client runs in its own thread and sends its next request once it took the
+// response to the previous one, while the server echoes the payload of the requests
+// from another node, so from another participant.
+//
+// Options, all optional:
+//   --clients=1,2,4,8,16
+//   --sizes=64,64K,1M             bytes of the request and response payloads
+//   --duration_s=5                of the calls of each run
+//   --timeout_ms=1000             after which a call is lost
+//   --format=json|csv
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosidl_typesupport_cpp/service_type_support.hpp"
+#include "test_msgs/srv/primitives.hpp"
+
+#include "./benchmark_common.hpp"
+
+namespace
+{
+
+using Service = test_msgs::srv::Primitives;
+
+class Waiter
+{
+public:
+  explicit Waiter(benchmark::Session & session)
+  : wait_set_(benchmark::check(
+        rmw_create_wait_set(session.context(), 1), "rmw_create_wait_set"))
+  {
+  }
+
+  ~Waiter()
+  {
+    rmw_destroy_wait_set(wait_set_);
+  }
+
+  /// Block until the service has a request or the client a response, or the timeout.
+  void
+  wait(rmw_service_t * service, rmw_client_t * client, int64_t timeout_ns)
+  {
+    void * service_handles[] = {service ? service->data : nullptr};
+    void * client_handles[] = {client ? client->data : nullptr};
+    rmw_services_t services = {service ? 1u : 0u, service_handles};
+    rmw_clients_t clients = {client ? 1u : 0u, client_handles};
+    rmw_time_t timeout = {
+      static_cast<uint64_t>(timeout_ns / 1000000000),
+      static_cast<uint64_t>(timeout_ns % 1000000000)};
+    rmw_ret_t ret = rmw_wait(nullptr, nullptr, &services, &clients, wait_set_, &timeout);
+    if (ret != RMW_RET_TIMEOUT) {
+      benchmark::check(ret, "rmw_wait");
+    }
+  }
+
+private:
+  rmw_wait_set_t * wait_set_;
+};
+
+void
+serve(benchmark::Session & session, rmw_service_t * service, const std::atomic<bool> & done)
+{
+  Waiter waiter(session);
+  Service::Request request;
+  Service::Response response;
+  rmw_request_id_t header;
+  while (!done.load()) {
+    bool taken = false;
+    benchmark::check(rmw_take_request(service, &header, &request, &taken), "rmw_take_request");
+    if (!taken) {
+      waiter.wait(service, nullptr, 100000000LL);
+      continue;
+    }
+    response.string_value = request.string_value;
+    benchmark::check(rmw_send_response(service, &header, &response), "rmw_send_response");
+  }
+}
+
+struct ClientResult
+{
+  std::vector<int64_t> latencies;
+  uint64_t lost = 0;
+};
+
+void
+call(
+  benchmark::Session & session, rmw_client_t * client, size_t payload_bytes,
+  int64_t end_ns, int64_t timeout_ns, ClientResult & result)
+{
+  Waiter waiter(session);
+  Service::Request request;
+  Service::Response response;
+  request.string_value.assign(payload_bytes, 'r');
+  while (benchmark::now_ns() < end_ns) {
+    int64_t sequence_id = 0;
+    int64_t start_ns = benchmark::now_ns();
+    int64_t deadline_ns = start_ns + timeout_ns;
+    benchmark::check(rmw_send_request(client, &request, &sequence_id), "rmw_send_request");
+    bool answered = false;
+    while (!answered && benchmark::now_ns() < deadline_ns) {
+      rmw_request_id_t header;
+      bool taken = false;
+      benchmark::check(
+        rmw_take_response(client, &header, &response, &taken), "rmw_take_response");
+      if (!taken) {
+        waiter.wait(nullptr, client, deadline_ns - benchmark::now_ns());
+      } else if (header.sequence_number == sequence_id) {
+        answered = true;
+      }
+    }
+    if (answered) {
+      result.latencies.push_back(benchmark::now_ns() - start_ns);
+    } else {
+      ++result.lost;
+    }
+  }
+}
+
+void
+measure(
+  benchmark::Session & session, size_t client_count, size_t payload_bytes,
+  int64_t duration_ns, int64_t timeout_ns, const std::string & format)
+{
+  auto type_support = rosidl_typesupport_cpp::get_service_type_support_handle<Service>();
+  rmw_qos_profile_t qos = rmw_qos_profile_services_default;
+  std::string name = "/service_benchmark_" + std::to_string(getpid()) + "_" +
+    std::to_string(client_count) + "_" + std::to_string(payload_bytes);
+  rmw_node_t * server_node = session.create_node("service_benchmark_server");
+  rmw_node_t * client_node = session.create_node("service_benchmark_clients");
+  rmw_service_t * service = benchmark::check(
+    rmw_create_service(server_node, type_support, name.c_str(), &qos), "rmw_create_service");
+  std::vector<rmw_client_t *> clients;
+  for (size_t i = 0; i < client_count; ++i) {
+    clients.push_back(benchmark::check(
+        rmw_create_client(client_node, type_support, name.c_str(), &qos), "rmw_create_client"));
+  }
+
+  std::atomic<bool> done(false);
+  std::thread server(serve, std::ref(session), service, std::cref(done));
+
+  // Warm up until every client got a response, which also completes discovery
+  int64_t discovery_end_ns = benchmark::now_ns() + 30000000000LL;
+  for (auto client : clients) {
+    ClientResult warm_up;
+    while (warm_up.latencies.empty() && benchmark::now_ns() < discovery_end_ns) {
+      call(session, client, payload_bytes, benchmark::now_ns() + 1, 100000000LL, warm_up);
+    }
+  }
+
+  std::vector<ClientResult> results(client_count);
+  std::vector<std::thread> callers;
+  int64_t start_ns = benchmark::now_ns();
+  int64_t end_ns = start_ns + duration_ns;
+  for (size_t i = 0; i < client_count; ++i) {
+    callers.emplace_back(
+      call, std::ref(session), clients[i], payload_bytes, end_ns, timeout_ns,
+      std::ref(results[i]));
+  }
+  for (auto & caller : callers) {
+    caller.join();
+  }
+  double elapsed_s = static_cast<double>(benchmark::now_ns() - start_ns) / 1e9;
+  done.store(true);
+  server.join();
+
+  std::vector<int64_t> latencies;
+  uint64_t lost = 0;
+  for (const auto & result : results) {
+    latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+    lost += result.lost;
+  }
+  benchmark::Record record("service");
+  record.add("clients", static_cast<uint64_t>(client_count))
+  .add("payload_bytes", static_cast<uint64_t>(payload_bytes))
+  .add("calls", static_cast<uint64_t>(latencies.size()))
+  .add("lost", lost)
+  .add("calls_per_s", static_cast<double>(latencies.size()) / elapsed_s);
+  benchmark::add_percentiles(record, "round_trip", latencies);
+  record.print(format);
+
+  for (auto client : clients) {
+    rmw_destroy_client(client_node, client);
+  }
+  rmw_destroy_service(server_node, service);
+  rmw_destroy_node(client_node);
+  rmw_destroy_node(server_node);
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+  std::string format = options.get("format", "json");
+  int64_t duration_ns = static_cast<int64_t>(options.number("duration_s", 5)) * 1000000000LL;
+  int64_t timeout_ns = static_cast<int64_t>(options.number("timeout_ms", 1000)) * 1000000LL;
+  benchmark::Session session;
+  for (auto client_count : options.numbers("clients", "1,2,4,8,16")) {
+    for (auto size : options.numbers("sizes", "64,64K,1M")) {
+      measure(session, client_count, size, duration_ns, timeout_ns, format);
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,393 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Cost of rmw_wait as the number of attached entities and the fraction of them which
+// are ready grow, and latency of the wakeup of a blocked wait set.
+//
+// For each kind of entity, count and ready fraction, the entities are made ready once,
+// or before each call for guard conditions, since waiting resets them. Each call then
+// waits with a zero timeout, so only the cost of scanning the entities is measured, in
+// wall and thread CPU time. The wakeup latency goes from the trigger of a guard condition
+// by another thread to the return of rmw_wait, blocked with the idle entities attached.
+//
+// Options, all optional:
+//   --kinds=subscriptions,guard_conditions,services,clients
+//   --counts=1,10,100,1000,5000
+//   --ready_fractions=0,0.01,0.1,1
+//   --calls=1000                  measured per point
+//   --wakeups=200                 measured per kind and count
+//   --format=json|csv
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_cpp/service_type_support.hpp"
+#include "test_msgs/msg/empty.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+#include "./benchmark_common.hpp"
+
+namespace
+{
+
+// A set of entities of one kind, of which the first `ready` ones are made ready
+class Entities
+{
+public:
+  Entities(
+    benchmark::Session & session, const std::string & kind, size_t count, size_t ready)
+  : kind_(kind), ready_(ready), node_(session.create_node("wait_set_benchmark"))
+  {
+    std::string suffix = std::to_string(getpid());
+    std::string ready_name = "/wait_set_benchmark_ready_" + suffix;
+    std::string idle_name = "/wait_set_benchmark_idle_" + suffix;
+    auto message_type_support =
+      rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Empty>();
+    auto service_type_support =
+      rosidl_typesupport_cpp::get_service_type_support_handle<test_msgs::srv::Empty>();
+    rmw_qos_profile_t qos = rmw_qos_profile_default;
+    rmw_qos_profile_t service_qos = rmw_qos_profile_services_default;
+
+    for (size_t i = 0; i < count; ++i) {
+      const std::string & name = i < ready ? ready_name : idle_name;
+      void * data = nullptr;
+      if (kind == "subscriptions") {
+        subscriptions_.push_back(benchmark::check(
+            rmw_create_subscription(node_, message_type_support, name.c_str(), &qos, false),
+            "rmw_create_subscription"));
+        data = subscriptions_.back()->data;
+      } else if (kind == "guard_conditions") {
+        guard_conditions_.push_back(benchmark::check(
+            rmw_create_guard_condition(session.context()), "rmw_create_guard_condition"));
+        data = guard_conditions_.back()->data;
+      } else if (kind == "services") {
+        services_.push_back(benchmark::check(
+            rmw_create_service(node_, service_type_support, name.c_str(), &service_qos),
+            "rmw_create_service"));
+        data = services_.back()->data;
+      } else if (kind == "clients") {
+        clients_.push_back(benchmark::check(
+            rmw_create_client(node_, service_type_support, name.c_str(), &service_qos),
+            "rmw_create_client"));
+        data = clients_.back()->data;
+      } else {
+        fprintf(stderr, "unknown kind '%s'\n", kind.c_str());
+        exit(EXIT_FAILURE);
+      }
+      handles_.push_back(data);
+    }
+
+    // What makes the ready entities ready
+    if (kind == "subscriptions") {
+      publisher_ = benchmark::check(
+        rmw_create_publisher(node_, message_type_support, ready_name.c_str(), &qos),
+        "rmw_create_publisher");
+    } else if (kind == "services") {
+      requester_ = benchmark::check(
+        rmw_create_client(node_, service_type_support, ready_name.c_str(), &service_qos),
+        "rmw_create_client");
+    } else if (kind == "clients") {
+      responder_ = benchmark::check(
+        rmw_create_service(node_, service_type_support, ready_name.c_str(), &service_qos),
+        "rmw_create_service");
+    }
+  }
+
+  ~Entities()
+  {
+    for (auto subscription : subscriptions_) {
+      rmw_destroy_subscription(node_, subscription);
+    }
+    for (auto guard_condition : guard_conditions_) {
+      rmw_destroy_guard_condition(guard_condition);
+    }
+    for (auto service : services_) {
+      rmw_destroy_service(node_, service);
+    }
+    for (auto client : clients_) {
+      rmw_destroy_client(node_, client);
+    }
+    if (publisher_) {
+      rmw_destroy_publisher(node_, publisher_);
+    }
+    if (requester_) {
+      rmw_destroy_client(node_, requester_);
+    }
+    if (responder_) {
+      rmw_destroy_service(node_, responder_);
+    }
+    rmw_destroy_node(node_);
+  }
+
+  /// Make the ready entities ready, retrying until discovery let all of them be.
+  bool
+  make_ready(rmw_wait_set_t * wait_set)
+  {
+    int64_t deadline_ns = benchmark::now_ns() + 30000000000LL;
+    while (benchmark::now_ns() < deadline_ns) {
+      poke();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      if (wait(wait_set, nullptr) == ready_) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Trigger the ready guard conditions, which rmw_wait resets.
+  void
+  rearm()
+  {
+    for (size_t i = 0; i < ready_ && kind_ == "guard_conditions"; ++i) {
+      benchmark::check(
+        rmw_trigger_guard_condition(guard_conditions_[i]), "rmw_trigger_guard_condition");
+    }
+  }
+
+  /// Wait without blocking on all the entities, plus an extra guard condition if given,
+  /// and return the number of ready entities.
+  size_t
+  wait(rmw_wait_set_t * wait_set, int64_t * duration_ns, int64_t * cpu_ns = nullptr,
+    const rmw_guard_condition_t * extra = nullptr, const rmw_time_t * timeout = &zero_timeout)
+  {
+    std::vector<void *> handles(handles_);
+    std::vector<void *> extra_handles;
+    if (extra) {
+      extra_handles.push_back(extra->data);
+    }
+    std::vector<void *> & guard_conditions =
+      kind_ == "guard_conditions" ? handles : extra_handles;
+    if (extra && kind_ == "guard_conditions") {
+      handles.push_back(extra->data);
+    }
+    rmw_subscriptions_t subscriptions = {0, nullptr};
+    rmw_guard_conditions_t guard_condition_set = {
+      guard_conditions.size(), guard_conditions.data()};
+    rmw_services_t services = {0, nullptr};
+    rmw_clients_t clients = {0, nullptr};
+    if (kind_ == "subscriptions") {
+      subscriptions = {handles.size(), handles.data()};
+    } else if (kind_ == "services") {
+      services = {handles.size(), handles.data()};
+    } else if (kind_ == "clients") {
+      clients = {handles.size(), handles.data()};
+    }
+
+    int64_t start_ns = benchmark::now_ns();
+    int64_t start_cpu_ns = benchmark::thread_cpu_ns();
+    rmw_ret_t ret = rmw_wait(
+      &subscriptions, &guard_condition_set, &services, &clients, wait_set, timeout);
+    if (cpu_ns) {
+      *cpu_ns = benchmark::thread_cpu_ns() - start_cpu_ns;
+    }
+    if (duration_ns) {
+      *duration_ns = benchmark::now_ns() - start_ns;
+    }
+    if (ret != RMW_RET_TIMEOUT) {
+      benchmark::check(ret, "rmw_wait");
+    }
+
+    size_t ready = 0;
+    for (auto handle : handles) {
+      ready += handle && (!extra || handle != extra->data) ? 1 : 0;
+    }
+    return ready;
+  }
+
+  size_t
+  size() const
+  {
+    return handles_.size();
+  }
+
+private:
+  static constexpr rmw_time_t zero_timeout = {0, 0};
+
+  void
+  poke()
+  {
+    if (kind_ == "guard_conditions") {
+      rearm();
+    } else if (kind_ == "subscriptions" && ready_ > 0) {
+      test_msgs::msg::Empty message;
+      benchmark::check(rmw_publish(publisher_, &message), "rmw_publish");
+    } else if (kind_ == "services" && ready_ > 0) {
+      test_msgs::srv::Empty::Request request;
+      int64_t sequence_id;
+      benchmark::check(rmw_send_request(requester_, &request, &sequence_id), "rmw_send_request");
+    } else if (kind_ == "clients") {
+      // Each client only takes the responses to its own requests
+      for (size_t i = 0; i < ready_; ++i) {
+        test_msgs::srv::Empty::Request request;
+        int64_t sequence_id;
+        benchmark::check(rmw_send_request(clients_[i], &request, &sequence_id),
+          "rmw_send_request");
+      }
+      test_msgs::srv::Empty::Request request;
+      test_msgs::srv::Empty::Response response;
+      rmw_request_id_t header;
+      bool taken = true;
+      int64_t deadline_ns = benchmark::now_ns() + 100000000LL;
+      while (benchmark::now_ns() < deadline_ns) {
+        benchmark::check(rmw_take_request(responder_, &header, &request, &taken),
+          "rmw_take_request");
+        if (taken) {
+          benchmark::check(rmw_send_response(responder_, &header, &response),
+            "rmw_send_response");
+        }
+      }
+    }
+  }
+
+  std::string kind_;
+  size_t ready_;
+  rmw_node_t * node_;
+  std::vector<rmw_subscription_t *> subscriptions_;
+  std::vector<rmw_guard_condition_t *> guard_conditions_;
+  std::vector<rmw_service_t *> services_;
+  std::vector<rmw_client_t *> clients_;
+  std::vector<void *> handles_;
+  rmw_publisher_t * publisher_ = nullptr;
+  rmw_client_t * requester_ = nullptr;
+  rmw_service_t * responder_ = nullptr;
+};
+
+constexpr rmw_time_t Entities::zero_timeout;
+
+void
+measure_calls(
+  benchmark::Session & session, const std::string & kind, size_t count, double fraction,
+  uint64_t calls, const std::string & format)
+{
+  size_t ready = static_cast<size_t>(std::ceil(fraction * static_cast<double>(count)));
+  Entities entities(session, kind, count, ready);
+  rmw_wait_set_t * wait_set = benchmark::check(
+    rmw_create_wait_set(session.context(), count + 1), "rmw_create_wait_set");
+  if (!entities.make_ready(wait_set)) {
+    fprintf(stderr, "not all of the %zu %s to be ready were\n", ready, kind.c_str());
+  }
+
+  std::vector<int64_t> durations;
+  std::vector<int64_t> cpu_times;
+  durations.reserve(calls);
+  cpu_times.reserve(calls);
+  size_t measured_ready = 0;
+  for (uint64_t i = 0; i < calls; ++i) {
+    entities.rearm();
+    int64_t duration_ns = 0;
+    int64_t cpu_ns = 0;
+    measured_ready = entities.wait(wait_set, &duration_ns, &cpu_ns);
+    durations.push_back(duration_ns);
+    cpu_times.push_back(cpu_ns);
+  }
+
+  benchmark::Record record("wait_set");
+  record.add("kind", kind)
+  .add("entities", static_cast<uint64_t>(count))
+  .add("ready_fraction", fraction)
+  .add("ready", static_cast<uint64_t>(measured_ready))
+  .add("calls", calls);
+  benchmark::add_percentiles(record, "wall", durations);
+  benchmark::add_percentiles(record, "cpu", cpu_times);
+  record.print(format);
+  rmw_destroy_wait_set(wait_set);
+}
+
+void
+measure_wakeups(
+  benchmark::Session & session, const std::string & kind, size_t count, uint64_t wakeups,
+  const std::string & format)
+{
+  Entities entities(session, kind, count, 0);
+  rmw_wait_set_t * wait_set = benchmark::check(
+    rmw_create_wait_set(session.context(), count + 1), "rmw_create_wait_set");
+  rmw_guard_condition_t * waker = benchmark::check(
+    rmw_create_guard_condition(session.context()), "rmw_create_guard_condition");
+
+  // The guard condition is triggered once per call, a while after the call started
+  std::atomic<int64_t> trigger_ns(0);
+  std::atomic<bool> armed(false);
+  std::atomic<bool> done(false);
+  std::thread trigger([&]() {
+      while (!done.load()) {
+        if (!armed.load()) {
+          std::this_thread::yield();
+          continue;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        trigger_ns.store(benchmark::now_ns());
+        armed.store(false);
+        benchmark::check(rmw_trigger_guard_condition(waker), "rmw_trigger_guard_condition");
+      }
+    });
+
+  std::vector<int64_t> latencies;
+  latencies.reserve(wakeups);
+  rmw_time_t timeout = {1, 0};
+  while (latencies.size() < wakeups) {
+    armed.store(true);
+    entities.wait(wait_set, nullptr, nullptr, waker, &timeout);
+    latencies.push_back(benchmark::now_ns() - trigger_ns.load());
+    // The trigger may not have happened yet if the call timed out
+    while (armed.load()) {
+      std::this_thread::yield();
+    }
+  }
+  done.store(true);
+  trigger.join();
+
+  benchmark::Record record("wait_set_wakeup");
+  record.add("kind", kind)
+  .add("entities", static_cast<uint64_t>(count))
+  .add("wakeups", wakeups);
+  benchmark::add_percentiles(record, "wakeup", latencies);
+  record.print(format);
+  rmw_destroy_guard_condition(waker);
+  rmw_destroy_wait_set(wait_set);
+}
+
+}  // namespace
+
+int
+main(int argc, char ** argv)
+{
+  benchmark::Options options(argc, argv);
+  std::string format = options.get("format", "json");
+  uint64_t calls = options.number("calls", 1000);
+  uint64_t wakeups = options.number("wakeups", 200);
+  benchmark::Session session;
+
+  for (const auto & kind : options.list("kinds",
+    "subscriptions,guard_conditions,services,clients"))
+  {
+    for (auto count : options.numbers("counts", "1,10,100,1000,5000")) {
+      for (const auto & fraction : options.list("ready_fractions", "0,0.01,0.1,1")) {
+        measure_calls(session, kind, count, atof(fraction.c_str()), calls, format);
+      }
+      measure_wakeups(session, kind, count, wakeups, format);
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -35,6 +35,11 @@ struct SerializedData
 {
   bool is_cdr_buffer;  // Whether next field is a pointer to a Cdr or to a plain ros message
   void * data;
+  // Whether serialize() and deserialize() time the conversion of a plain ros message
+  bool time_conversion;
+  // Set by serialize() and deserialize()
+  size_t cdr_length;  // Serialized length of the sample
+  uint64_t conversion_time_ns;  // Time spent converting between the ros message and cdr
 };
 
 class TypeSupport : public eprosima::fastrtps::TopicDataType
@@ -74,6 +79,13 @@ public:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   virtual ~TypeSupport() {}
 
+  // Whether m_typeSize is an upper bound of the serialized size of every message
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool is_bounded() const
+  {
+    return max_size_bound_;
+  }
+
 protected:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   TypeSupport();
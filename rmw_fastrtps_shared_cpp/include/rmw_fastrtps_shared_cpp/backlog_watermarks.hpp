@@ -0,0 +1,116 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__BACKLOG_WATERMARKS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__BACKLOG_WATERMARKS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// High and low watermarks on the backlog of a subscription or service.
+/**
+ * The backlog crosses the high watermark when it grows up to it, and only
+ * crosses the low watermark back once it shrinks down to it, so that a backlog
+ * oscillating around a single threshold does not notify on every sample.
+ */
+class BacklogWatermarks
+{
+public:
+  enum Crossing
+  {
+    NO_CROSSING,
+    HIGH_CROSSING,
+    LOW_CROSSING
+  };
+
+  BacklogWatermarks()
+  : enabled_(false), high_(0), low_(0), above_(false)
+  {
+  }
+
+  /// Set the watermarks and what to call when crossing them, a zero high watermark disables them.
+  void
+  set(size_t high, size_t low, std::function<void()> on_high, std::function<void()> on_low)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    high_ = high;
+    low_ = low;
+    on_high_ = std::move(on_high);
+    on_low_ = std::move(on_low);
+    above_ = false;
+    enabled_.store(high > 0);
+  }
+
+  // Must be called with the lock guarding the backlog held
+  Crossing
+  update(size_t backlog)
+  {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+      return NO_CROSSING;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!above_ && high_ > 0 && backlog >= high_) {
+      above_ = true;
+      return HIGH_CROSSING;
+    }
+    if (above_ && backlog <= low_) {
+      above_ = false;
+      return LOW_CROSSING;
+    }
+    return NO_CROSSING;
+  }
+
+  // Must be called without the listener lock held, as it may trigger a wait set
+  void
+  notify(Crossing crossing)
+  {
+    if (NO_CROSSING == crossing) {
+      return;
+    }
+    std::function<void()> callback;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      callback = HIGH_CROSSING == crossing ? on_high_ : on_low_;
+    }
+    if (callback) {
+      callback();
+    }
+  }
+
+  bool
+  above_high_watermark() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return above_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::atomic_bool enabled_;
+  size_t high_;
+  size_t low_;
+  bool above_;
+  std::function<void()> on_high_;
+  std::function<void()> on_low_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__BACKLOG_WATERMARKS_HPP_
@@ -0,0 +1,119 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__BUFFER_POOL_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__BUFFER_POOL_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "fastcdr/FastBuffer.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// CDR buffers of the requests or responses received by a service or a client.
+/**
+ * By default a buffer is allocated for every sample, and deleted once the sample is taken.
+ * Once preallocated, the pool keeps the released buffers for the next samples instead.
+ * A reused buffer keeps the capacity of the largest sample it held, so the pool stops
+ * allocating once it has grown to the peak backlog and the largest sample size.
+ */
+class BufferPool
+{
+public:
+  BufferPool()
+  : reuse_(false)
+  {
+  }
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool & operator=(const BufferPool &) = delete;
+
+  ~BufferPool()
+  {
+    for (auto buffer : buffers_) {
+      delete buffer;
+    }
+  }
+
+  /// Allocate `count` buffers of `buffer_size` bytes, and keep the released buffers from now on.
+  void
+  preallocate(size_t count, size_t buffer_size)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reuse_ = true;
+    buffers_.reserve(count);
+    while (buffers_.size() < count) {
+      auto buffer = new eprosima::fastcdr::FastBuffer();
+      if (buffer_size > 0) {
+        buffer->reserve(buffer_size);
+      }
+      buffers_.push_back(buffer);
+    }
+  }
+
+  eprosima::fastcdr::FastBuffer *
+  acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!buffers_.empty()) {
+        auto buffer = buffers_.back();
+        buffers_.pop_back();
+        return buffer;
+      }
+    }
+    return new eprosima::fastcdr::FastBuffer();
+  }
+
+  void
+  release(eprosima::fastcdr::FastBuffer * buffer)
+  {
+    if (!buffer) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (reuse_) {
+        buffers_.push_back(buffer);
+        return;
+      }
+    }
+    delete buffer;
+  }
+
+  /// Return the memory held by the pooled buffers, besides those in use.
+  size_t
+  memoryFootprint()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = buffers_.capacity() * sizeof(eprosima::fastcdr::FastBuffer *);
+    for (auto buffer : buffers_) {
+      bytes += sizeof(eprosima::fastcdr::FastBuffer) + buffer->getBufferSize();
+    }
+    return bytes;
+  }
+
+private:
+  std::mutex mutex_;
+  bool reuse_;
+  std::vector<eprosima::fastcdr::FastBuffer *> buffers_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__BUFFER_POOL_HPP_
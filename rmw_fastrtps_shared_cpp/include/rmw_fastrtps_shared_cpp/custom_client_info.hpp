@@ -31,6 +31,13 @@
 #include "fastrtps/publisher/Publisher.h"
 #include "fastrtps/publisher/PublisherListener.h"
 
+#include "rmw_fastrtps_shared_cpp/buffer_pool.hpp"
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/round_trip_tracker.hpp"
+#include "rmw_fastrtps_shared_cpp/taken_sample_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class ClientListener;
@@ -49,21 +56,51 @@ typedef struct CustomClientInfo
   ClientPubListener * pub_listener_;
   uint32_t response_subscriber_matched_count_;
   uint32_t request_publisher_matched_count_;
+  rmw_fastrtps_shared_cpp::EntityCounters counters_;
+  rmw_fastrtps_shared_cpp::TakenSampleInfo last_taken_;
+  rmw_fastrtps_shared_cpp::RoundTripTracker round_trip_;
+  // Payloads preallocated by the histories of both endpoints
+  size_t preallocated_history_size_;
 } CustomClientInfo;
 
 typedef struct CustomClientResponse
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
   std::unique_ptr<eprosima::fastcdr::FastBuffer> buffer_;
+  // Serialized size of the response, a reused buffer being possibly larger
+  size_t length_;
+  // Sequence number of the response itself, while sample_identity_ is the one of the request
+  int64_t sequence_number_;
+  int64_t source_timestamp_ns_;
+  int64_t reception_timestamp_ns_;
 } CustomClientResponse;
 
 class ClientListener : public eprosima::fastrtps::SubscriberListener
 {
 public:
   explicit ClientListener(CustomClientInfo * info)
-  : info_(info), list_has_data_(false),
+  : info_(info), list_has_data_(false), reuse_nodes_(false),
     conditionMutex_(nullptr), conditionVariable_(nullptr) {}
 
+  /// Allocate the buffers and list nodes of `count` responses, and reuse them once taken.
+  void
+  preallocate(size_t count, size_t buffer_size)
+  {
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    reuse_nodes_ = true;
+    if (free_nodes_.size() < count) {
+      free_nodes_.resize(count);
+    }
+    buffers_.preallocate(count, buffer_size);
+  }
+
+  /// Give back the buffer of a taken response.
+  void
+  releaseBuffer(eprosima::fastcdr::FastBuffer * buffer)
+  {
+    buffers_.release(buffer);
+  }
+
 
   void
   onNewDataMessage(eprosima::fastrtps::Subscriber * sub)
@@ -72,7 +109,7 @@ public:
 
     CustomClientResponse response;
     // Todo(sloretz) eliminate heap allocation pending eprosima/Fast-CDR#19
-    response.buffer_.reset(new eprosima::fastcdr::FastBuffer());
+    response.buffer_.reset(buffers_.acquire());
     eprosima::fastrtps::SampleInfo_t sinfo;
 
     rmw_fastrtps_shared_cpp::SerializedData data;
@@ -81,13 +118,20 @@ public:
     if (sub->takeNextData(&data, &sinfo)) {
       if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
         response.sample_identity_ = sinfo.related_sample_identity;
+        response.length_ = data.cdr_length;
+        response.sequence_number_ = rmw_fastrtps_shared_cpp::sequence_number_to_int64(
+          sinfo.sample_identity.sequence_number());
+        response.source_timestamp_ns_ =
+          rmw_fastrtps_shared_cpp::time_to_nanoseconds(sinfo.sourceTimestamp);
+        response.reception_timestamp_ns_ = rmw_fastrtps_shared_cpp::current_time_nanoseconds();
 
         if (response.sample_identity_.writer_guid() == info_->writer_guid_) {
           std::lock_guard<std::mutex> lock(internalMutex_);
 
           if (conditionMutex_ != nullptr) {
             std::unique_lock<std::mutex> clock(*conditionMutex_);
-            list.emplace_back(std::move(response));
+            pushResponse(response);
+            info_->counters_.set_backlog(list.size());
             // the change to list_has_data_ needs to be mutually exclusive with
             // rmw_wait() which checks hasData() and decides if wait() needs to
             // be called
@@ -95,12 +139,15 @@ public:
             clock.unlock();
             conditionVariable_->notify_one();
           } else {
-            list.emplace_back(std::move(response));
+            pushResponse(response);
+            info_->counters_.set_backlog(list.size());
             list_has_data_.store(true);
           }
         }
       }
     }
+    // responses to the other clients of the service are dropped
+    buffers_.release(response.buffer_.release());
   }
 
   bool
@@ -111,8 +158,8 @@ public:
     auto pop_response = [this](CustomClientResponse & response) -> bool
       {
         if (!list.empty()) {
-          response = std::move(list.front());
-          list.pop_front();
+          popResponse(response);
+          info_->counters_.set_backlog(list.size());
           list_has_data_.store(!list.empty());
           return true;
         }
@@ -148,6 +195,22 @@ public:
     return list_has_data_.load();
   }
 
+  // Estimated memory of the queued responses, of the free list nodes and of the pooled buffers
+  size_t
+  memoryFootprint()
+  {
+    size_t bytes = buffers_.memoryFootprint();
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    bytes += (list.size() + free_nodes_.size()) *
+      (sizeof(CustomClientResponse) + rmw_fastrtps_shared_cpp::list_node_overhead);
+    for (const auto & response : list) {
+      if (response.buffer_) {
+        bytes += sizeof(eprosima::fastcdr::FastBuffer) + response.buffer_->getBufferSize();
+      }
+    }
+    return bytes;
+  }
+
   void onSubscriptionMatched(
     eprosima::fastrtps::Subscriber * sub,
     eprosima::fastrtps::rtps::MatchingInfo & matchingInfo)
@@ -164,10 +227,40 @@ public:
   }
 
 private:
+  // Move a response to the end of the list, reusing a free list node when there is one.
+  // Must be called with internalMutex_ held.
+  void
+  pushResponse(CustomClientResponse & response)
+  {
+    if (free_nodes_.empty()) {
+      list.emplace_back(std::move(response));
+      return;
+    }
+    free_nodes_.front() = std::move(response);
+    list.splice(list.end(), free_nodes_, free_nodes_.begin());
+  }
+
+  // Move out the first response, keeping its list node when they are reused.
+  // Must be called with internalMutex_ held, and with a non empty list.
+  void
+  popResponse(CustomClientResponse & response)
+  {
+    response = std::move(list.front());
+    if (reuse_nodes_) {
+      free_nodes_.splice(free_nodes_.end(), list, list.begin());
+    } else {
+      list.pop_front();
+    }
+  }
+
   CustomClientInfo * info_;
   std::mutex internalMutex_;
   std::list<CustomClientResponse> list;
   std::atomic_bool list_has_data_;
+  // Nodes of taken responses, kept for the next ones once preallocated
+  std::list<CustomClientResponse> free_nodes_;
+  bool reuse_nodes_;
+  rmw_fastrtps_shared_cpp::BufferPool buffers_;
   std::mutex * conditionMutex_;
   std::condition_variable * conditionVariable_;
 };
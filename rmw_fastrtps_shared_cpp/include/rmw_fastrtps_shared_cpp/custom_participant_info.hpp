@@ -15,14 +15,21 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "fastrtps/attributes/ParticipantAttributes.h"
 #include "fastrtps/participant/Participant.h"
 #include "fastrtps/participant/ParticipantListener.h"
+#include "fastrtps/rtps/attributes/ReaderAttributes.h"
+#include "fastrtps/rtps/attributes/WriterAttributes.h"
+#include "fastrtps/rtps/flowcontrol/ThroughputControllerDescriptor.h"
 
 #include "rcutils/logging_macros.h"
 
@@ -30,11 +37,24 @@
 #include "rmw/rmw.h"
 
 #include "rmw_common.hpp"
+#include "tracepoints.hpp"
+
+#include "discovery_counters.hpp"
+#include "entity_counters.hpp"
+#include "statistics_export.hpp"
+#include "time_utils.hpp"
 
 #include "topic_cache.hpp"
 
 class ParticipantListener;
 
+enum class publishing_mode_t
+{
+  ASYNCHRONOUS,  // Asynchronous publishing mode
+  SYNCHRONOUS,   // Synchronous publishing mode
+  AUTO           // Synchronous for small bounded types, asynchronous otherwise
+};
+
 typedef struct CustomParticipantInfo
 {
   eprosima::fastrtps::Participant * participant;
@@ -47,13 +67,64 @@ typedef struct CustomParticipantInfo
   // their settings are going to be overwritten by code
   // with the default configuration.
   bool leave_middleware_default_qos;
+
+  // Publishing mode applied to the writers of this participant,
+  // selected through the RMW_FASTRTPS_PUBLICATION_MODE env variable.
+  publishing_mode_t publishing_mode;
+
+  // Bandwidth limit applied to each asynchronous publisher of this participant,
+  // selected through the RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT env variable.
+  eprosima::fastrtps::rtps::ThroughputControllerDescriptor publisher_throughput_controller;
+
+  // Names of the topics and services whose writers get the high priority class,
+  // selected through the RMW_FASTRTPS_HIGH_PRIORITY_TOPICS env variable.
+  // Only writers of bounded types fitting in a single RTPS message get the synchronous
+  // lane; writers of unbounded or bigger types keep the asynchronous writer, with a warning.
+  std::set<std::string> high_priority_topics;
+
+  // Timings of the reliable writers and readers of this participant.
+  // They hold the default XML profile values, overridden by the
+  // RMW_FASTRTPS_*_MS env variables. benchmark/lossy_loopback.sh of
+  // rmw_fastrtps_shared_cpp measures how fast they repair losses.
+  eprosima::fastrtps::rtps::WriterTimes writer_times;
+  eprosima::fastrtps::rtps::ReaderTimes reader_times;
+
+  // Resource limits of KEEP_ALL histories, from the
+  // RMW_FASTRTPS_KEEP_ALL_MAX_SAMPLES and RMW_FASTRTPS_KEEP_ALL_ALLOCATED_SAMPLES
+  // env variables. Zero means they are derived from the QoS depth.
+  int32_t keep_all_max_samples;
+  int32_t keep_all_allocated_samples;
+
+  // Minimum separation between the samples taken by the subscriptions of a topic,
+  // from the RMW_FASTRTPS_MINIMUM_SEPARATION_MS env variable.
+  std::map<std::string, eprosima::fastrtps::rtps::Duration_t> minimum_separations;
+
+  // Maximum age of the samples taken by the subscriptions of a topic,
+  // from the RMW_FASTRTPS_MAX_SAMPLE_AGE_MS env variable.
+  std::map<std::string, eprosima::fastrtps::rtps::Duration_t> max_sample_ages;
+
+  // Names of the topics whose subscriptions only keep the latest sample in a mailbox,
+  // selected through the RMW_FASTRTPS_MAILBOX_TOPICS env variable.
+  std::set<std::string> mailbox_topics;
+
+  // Whether the histories and take buffers of the entities are all allocated at their
+  // creation, set through the RMW_FASTRTPS_ZERO_ALLOCATION env variable.
+  bool zero_allocation;
+
+  // Counters of the publishers, subscriptions, services and clients of this node, which
+  // only time their conversions when the RMW_FASTRTPS_CONVERSION_TIMING env variable is 1.
+  rmw_fastrtps_shared_cpp::EntityCountersRegistry entity_counters;
+
+  // Exporter of the statistics file of the process, shared by its nodes, null unless enabled
+  // through the RMW_FASTRTPS_STATISTICS_EXPORT_DIR env variable.
+  std::shared_ptr<rmw_fastrtps_shared_cpp::StatisticsExporter> statistics_exporter;
 } CustomParticipantInfo;
 
 class ParticipantListener : public eprosima::fastrtps::ParticipantListener
 {
 public:
   explicit ParticipantListener(rmw_guard_condition_t * graph_guard_condition)
-  : graph_guard_condition_(graph_guard_condition)
+  : discovered_participant_count_(0), graph_guard_condition_(graph_guard_condition)
   {}
 
   void onParticipantDiscovery(
@@ -67,6 +138,7 @@ public:
     {
       return;
     }
+    auto start = std::chrono::steady_clock::now();
 
     if (eprosima::fastrtps::rtps::ParticipantDiscoveryInfo::DISCOVERED_PARTICIPANT == info.status) {
       // ignore already known GUIDs
@@ -111,6 +183,10 @@ public:
         }
       }
     }
+    discovered_participant_count_.store(discovered_names.size());
+    discovery_counters_.participant_discovered(
+      eprosima::fastrtps::rtps::ParticipantDiscoveryInfo::DISCOVERED_PARTICIPANT == info.status);
+    discovery_counters_.callback_done(rmw_fastrtps_shared_cpp::elapsed_nanoseconds(start));
   }
 
   std::vector<std::string> get_discovered_names() const
@@ -158,6 +234,8 @@ public:
   template<class T>
   void process_discovery_info(T & proxyData, bool is_alive, bool is_reader)
   {
+    RMW_FASTRTPS_TRACEPOINT(discovery, &proxyData.guid(), is_alive ? 1 : 0, is_reader ? 1 : 0);
+    auto start = std::chrono::steady_clock::now();
     auto & topic_cache =
       is_reader ? reader_topic_cache : writer_topic_cache;
 
@@ -174,17 +252,23 @@ public:
       }
     }
     if (trigger) {
+      discovery_counters_.graph_changed(rmw_fastrtps_shared_cpp::current_time_nanoseconds());
       rmw_fastrtps_shared_cpp::__rmw_trigger_guard_condition(
         graph_guard_condition_->implementation_identifier,
         graph_guard_condition_);
     }
+    discovery_counters_.endpoint_discovered(is_reader, is_alive);
+    discovery_counters_.callback_done(rmw_fastrtps_shared_cpp::elapsed_nanoseconds(start));
   }
 
   std::map<eprosima::fastrtps::rtps::GUID_t, std::string> discovered_names;
   std::map<eprosima::fastrtps::rtps::GUID_t, std::string> discovered_namespaces;
+  // Size of discovered_names, which may be read from other threads
+  std::atomic<size_t> discovered_participant_count_;
   LockedObject<TopicCache> reader_topic_cache;
   LockedObject<TopicCache> writer_topic_cache;
   rmw_guard_condition_t * graph_guard_condition_;
+  rmw_fastrtps_shared_cpp::DiscoveryCounters discovery_counters_;
 };
 
 #endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
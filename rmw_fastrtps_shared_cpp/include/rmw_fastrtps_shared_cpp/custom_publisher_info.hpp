@@ -15,6 +15,7 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 
+#include <atomic>
 #include <mutex>
 #include <set>
 
@@ -23,6 +24,9 @@
 
 #include "rmw/rmw.h"
 
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/rate_counters.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class PubListener;
@@ -34,6 +38,12 @@ typedef struct CustomPublisherInfo
   rmw_fastrtps_shared_cpp::TypeSupport * type_support_;
   rmw_gid_t publisher_gid;
   const char * typesupport_identifier_;
+  // Samples which did not fit in the full history of a KEEP_ALL publisher
+  std::atomic<uint64_t> history_overflow_count_;
+  rmw_fastrtps_shared_cpp::EntityCounters counters_;
+  rmw_fastrtps_shared_cpp::RateCounters rate_;
+  // Payloads preallocated by the history of the endpoint
+  size_t preallocated_history_size_;
 } CustomPublisherInfo;
 
 class PubListener : public eprosima::fastrtps::PublisherListener
@@ -63,6 +73,15 @@ public:
     return subscriptions_.size();
   }
 
+  // Estimated memory of the matched subscriptions
+  size_t memoryFootprint()
+  {
+    constexpr size_t node_size =
+      sizeof(eprosima::fastrtps::rtps::GUID_t) + rmw_fastrtps_shared_cpp::tree_node_overhead;
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    return subscriptions_.size() * node_size;
+  }
+
 private:
   std::mutex internalMutex_;
   std::set<eprosima::fastrtps::rtps::GUID_t> subscriptions_;
@@ -29,6 +29,12 @@
 #include "fastrtps/subscriber/SubscriberListener.h"
 #include "fastrtps/subscriber/SampleInfo.h"
 
+#include "rmw_fastrtps_shared_cpp/backlog_watermarks.hpp"
+#include "rmw_fastrtps_shared_cpp/buffer_pool.hpp"
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/taken_sample_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class ServiceListener;
@@ -42,25 +48,59 @@ typedef struct CustomServiceInfo
   ServiceListener * listener_;
   eprosima::fastrtps::Participant * participant_;
   const char * typesupport_identifier_;
+  rmw_fastrtps_shared_cpp::EntityCounters counters_;
+  rmw_fastrtps_shared_cpp::TakenSampleInfo last_taken_;
+  rmw_fastrtps_shared_cpp::BacklogWatermarks backlog_watermarks_;
+  // Payloads preallocated by the histories of both endpoints
+  size_t preallocated_history_size_;
 } CustomServiceInfo;
 
 typedef struct CustomServiceRequest
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
   eprosima::fastcdr::FastBuffer * buffer_;
+  // Serialized size of the request, a reused buffer being possibly larger
+  size_t length_;
+  int64_t source_timestamp_ns_;
+  int64_t reception_timestamp_ns_;
 
   CustomServiceRequest()
-  : buffer_(nullptr) {}
+  : buffer_(nullptr), length_(0), source_timestamp_ns_(0), reception_timestamp_ns_(0) {}
 } CustomServiceRequest;
 
 class ServiceListener : public eprosima::fastrtps::SubscriberListener
 {
 public:
   explicit ServiceListener(CustomServiceInfo * info)
-  : info_(info), list_has_data_(false),
+  : info_(info), list_has_data_(false), reuse_nodes_(false),
     conditionMutex_(nullptr), conditionVariable_(nullptr)
   {
-    (void)info_;
+  }
+
+  ~ServiceListener()
+  {
+    for (auto & request : list) {
+      delete request.buffer_;
+    }
+  }
+
+  /// Allocate the buffers and list nodes of `count` requests, and reuse them once taken.
+  void
+  preallocate(size_t count, size_t buffer_size)
+  {
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    reuse_nodes_ = true;
+    if (free_nodes_.size() < count) {
+      free_nodes_.resize(count);
+    }
+    buffers_.preallocate(count, buffer_size);
+  }
+
+  /// Give back the buffer of a taken request.
+  void
+  releaseBuffer(eprosima::fastcdr::FastBuffer * buffer)
+  {
+    buffers_.release(buffer);
   }
 
 
@@ -70,7 +110,7 @@ public:
     assert(sub);
 
     CustomServiceRequest request;
-    request.buffer_ = new eprosima::fastcdr::FastBuffer();
+    request.buffer_ = buffers_.acquire();
     eprosima::fastrtps::SampleInfo_t sinfo;
 
     rmw_fastrtps_shared_cpp::SerializedData data;
@@ -79,12 +119,19 @@ public:
     if (sub->takeNextData(&data, &sinfo)) {
       if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
         request.sample_identity_ = sinfo.sample_identity;
+        request.length_ = data.cdr_length;
+        request.source_timestamp_ns_ =
+          rmw_fastrtps_shared_cpp::time_to_nanoseconds(sinfo.sourceTimestamp);
+        request.reception_timestamp_ns_ = rmw_fastrtps_shared_cpp::current_time_nanoseconds();
 
-        std::lock_guard<std::mutex> lock(internalMutex_);
+        std::unique_lock<std::mutex> lock(internalMutex_);
+        auto crossing = rmw_fastrtps_shared_cpp::BacklogWatermarks::NO_CROSSING;
 
         if (conditionMutex_ != nullptr) {
           std::unique_lock<std::mutex> clock(*conditionMutex_);
-          list.push_back(request);
+          pushRequest(request);
+          info_->counters_.set_backlog(list.size());
+          crossing = info_->backlog_watermarks_.update(list.size());
           // the change to list_has_data_ needs to be mutually exclusive with
           // rmw_wait() which checks hasData() and decides if wait() needs to
           // be called
@@ -92,34 +139,46 @@ public:
           clock.unlock();
           conditionVariable_->notify_one();
         } else {
-          list.push_back(request);
+          pushRequest(request);
+          info_->counters_.set_backlog(list.size());
+          crossing = info_->backlog_watermarks_.update(list.size());
           list_has_data_.store(true);
         }
+
+        lock.unlock();
+        info_->backlog_watermarks_.notify(crossing);
+        return;
       }
     }
+    buffers_.release(request.buffer_);
   }
 
   CustomServiceRequest
   getRequest()
   {
-    std::lock_guard<std::mutex> lock(internalMutex_);
+    std::unique_lock<std::mutex> lock(internalMutex_);
     CustomServiceRequest request;
+    auto crossing = rmw_fastrtps_shared_cpp::BacklogWatermarks::NO_CROSSING;
 
     if (conditionMutex_ != nullptr) {
       std::unique_lock<std::mutex> clock(*conditionMutex_);
       if (!list.empty()) {
-        request = list.front();
-        list.pop_front();
+        request = popRequest();
+        info_->counters_.set_backlog(list.size());
+        crossing = info_->backlog_watermarks_.update(list.size());
         list_has_data_.store(!list.empty());
       }
     } else {
       if (!list.empty()) {
-        request = list.front();
-        list.pop_front();
+        request = popRequest();
+        info_->counters_.set_backlog(list.size());
+        crossing = info_->backlog_watermarks_.update(list.size());
         list_has_data_.store(!list.empty());
       }
     }
 
+    lock.unlock();
+    info_->backlog_watermarks_.notify(crossing);
     return request;
   }
 
@@ -145,11 +204,58 @@ public:
     return list_has_data_.load();
   }
 
+  // Estimated memory of the queued requests, of the free list nodes and of the pooled buffers
+  size_t
+  memoryFootprint()
+  {
+    size_t bytes = buffers_.memoryFootprint();
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    bytes += (list.size() + free_nodes_.size()) *
+      (sizeof(CustomServiceRequest) + rmw_fastrtps_shared_cpp::list_node_overhead);
+    for (const auto & request : list) {
+      if (request.buffer_) {
+        bytes += sizeof(eprosima::fastcdr::FastBuffer) + request.buffer_->getBufferSize();
+      }
+    }
+    return bytes;
+  }
+
 private:
+  // Append a request, reusing a free list node when there is one.
+  // Must be called with internalMutex_ held.
+  void
+  pushRequest(const CustomServiceRequest & request)
+  {
+    if (free_nodes_.empty()) {
+      list.push_back(request);
+      return;
+    }
+    free_nodes_.front() = request;
+    list.splice(list.end(), free_nodes_, free_nodes_.begin());
+  }
+
+  // Remove the first request, keeping its list node when they are reused.
+  // Must be called with internalMutex_ held, and with a non empty list.
+  CustomServiceRequest
+  popRequest()
+  {
+    CustomServiceRequest request = list.front();
+    if (reuse_nodes_) {
+      free_nodes_.splice(free_nodes_.end(), list, list.begin());
+    } else {
+      list.pop_front();
+    }
+    return request;
+  }
+
   CustomServiceInfo * info_;
   std::mutex internalMutex_;
   std::list<CustomServiceRequest> list;
   std::atomic_bool list_has_data_;
+  // Nodes of taken requests, kept for the next ones once preallocated
+  std::list<CustomServiceRequest> free_nodes_;
+  bool reuse_nodes_;
+  rmw_fastrtps_shared_cpp::BufferPool buffers_;
   std::mutex * conditionMutex_;
   std::condition_variable * conditionVariable_;
 };
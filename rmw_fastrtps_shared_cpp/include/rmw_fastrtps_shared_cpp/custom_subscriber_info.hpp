@@ -17,34 +17,95 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <utility>
 
+#include "fastcdr/FastBuffer.h"
+
+#include "fastrtps/subscriber/SampleInfo.h"
 #include "fastrtps/subscriber/Subscriber.h"
 #include "fastrtps/subscriber/SubscriberListener.h"
 
+#include "rmw_fastrtps_shared_cpp/backlog_watermarks.hpp"
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/latency_histogram.hpp"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/rate_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/reception_times.hpp"
+#include "rmw_fastrtps_shared_cpp/sample_loss.hpp"
+#include "rmw_fastrtps_shared_cpp/taken_sample_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class SubListener;
 
+// Whether a serialized sample may be taken
+typedef std::function<bool(eprosima::fastcdr::FastBuffer &)> SampleFilter;
+
+// Single slot holding the latest sample of a mailbox subscription.
+// Every new sample is taken from the history as soon as it arrives and overwrites the
+// previous one in place.
+typedef struct SubscriberMailbox
+{
+  std::mutex mutex_;
+  eprosima::fastcdr::FastBuffer buffer_;
+  size_t length_;
+  eprosima::fastrtps::SampleInfo_t sinfo_;
+  int64_t reception_time_ns_;
+  // Whether the slot holds a sample, and whether it has been taken or read since it arrived
+  bool full_;
+  bool unread_;
+} SubscriberMailbox;
+
 typedef struct CustomSubscriberInfo
 {
   eprosima::fastrtps::Subscriber * subscriber_;
   SubListener * listener_;
   rmw_fastrtps_shared_cpp::TypeSupport * type_support_;
   const char * typesupport_identifier_;
+  // Minimum separation between the source timestamps of taken samples, zero to take them all
+  int64_t minimum_separation_ns_;
+  int64_t last_taken_timestamp_ns_;
+  // Maximum age of the taken samples, from their source timestamp, zero to take them all
+  int64_t max_sample_age_ns_;
+  std::atomic<uint64_t> expired_sample_count_;
+  // Content filter of the taken samples, null to take them all. It may be replaced while
+  // other threads take, so it is only accessed through std::atomic_load and std::atomic_store.
+  std::shared_ptr<const SampleFilter> content_filter_;
+  // Latest sample of the topic, only for mailbox subscriptions
+  std::unique_ptr<SubscriberMailbox> mailbox_;
+  // Buffer overwritten by every serialized take, only in zero allocation mode, so that
+  // a subscription must not then be taken from several threads at once
+  std::unique_ptr<eprosima::fastcdr::FastBuffer> take_buffer_;
+  rmw_fastrtps_shared_cpp::EntityCounters counters_;
+  // From the source timestamp to the reception, and from the reception to the take
+  rmw_fastrtps_shared_cpp::LatencyHistogramCounters transport_latency_;
+  rmw_fastrtps_shared_cpp::LatencyHistogramCounters queueing_latency_;
+  rmw_fastrtps_shared_cpp::TakenSampleInfo last_taken_;
+  // Gaps in the sequence numbers of every matched writer
+  rmw_fastrtps_shared_cpp::SampleLossTracker sample_loss_;
+  rmw_fastrtps_shared_cpp::BacklogWatermarks backlog_watermarks_;
+  // Received samples, whether they are then filtered or not
+  rmw_fastrtps_shared_cpp::RateCounters rate_;
+  // Payloads preallocated by the history of the endpoint
+  size_t preallocated_history_size_;
 } CustomSubscriberInfo;
 
 class SubListener : public eprosima::fastrtps::SubscriberListener
 {
 public:
   explicit SubListener(CustomSubscriberInfo * info)
-  : data_(0),
+  : data_(0), history_limit_known_(false), history_limit_(0), history_full_(false),
+    history_became_full_count_(0),
+    mailbox_(info->mailbox_.get()), counters_(&info->counters_),
+    sample_loss_(&info->sample_loss_), watermarks_(&info->backlog_watermarks_),
+    rate_(&info->rate_),
     conditionMutex_(nullptr), conditionVariable_(nullptr)
   {
-    // Field is not used right now
-    (void)info;
   }
 
   void
@@ -58,14 +119,20 @@ public:
       publishers_.insert(info.remoteEndpointGuid);
     } else if (eprosima::fastrtps::rtps::REMOVED_MATCHING == info.status) {
       publishers_.erase(info.remoteEndpointGuid);
+      sample_loss_->writer_removed(info.remoteEndpointGuid);
     }
   }
 
   void
   onNewDataMessage(eprosima::fastrtps::Subscriber * sub)
   {
-    (void)sub;
-    std::lock_guard<std::mutex> lock(internalMutex_);
+    if (mailbox_ != nullptr) {
+      onNewMailboxMessage(sub);
+      return;
+    }
+
+    int64_t reception_time = rmw_fastrtps_shared_cpp::current_time_nanoseconds();
+    std::unique_lock<std::mutex> lock(internalMutex_);
 
     if (conditionMutex_ != nullptr) {
       std::unique_lock<std::mutex> clock(*conditionMutex_);
@@ -77,6 +144,92 @@ public:
     } else {
       data_ = sub->getUnreadCount();
     }
+    counters_->set_backlog(data_);
+    auto crossing = watermarks_->update(data_);
+    // the sample is still in the history, its writer and sequence number are only known once
+    // it is removed from it, by the sample_received probe
+    RMW_FASTRTPS_TRACEPOINT(data_received, &sub->getGuid(), data_.load());
+
+    // samples are taken oldest first, and the oldest is the one replaced in a full history
+    reception_times_.push(reception_time, data_);
+
+    if (!history_limit_known_) {
+      const auto & topic = sub->getAttributes().topic;
+      if (
+        eprosima::fastrtps::KEEP_ALL_HISTORY_QOS == topic.historyQos.kind &&
+        topic.resourceLimitsQos.max_samples > 0)
+      {
+        history_limit_ = static_cast<size_t>(topic.resourceLimitsQos.max_samples);
+      }
+      history_limit_known_ = true;
+    }
+    // A full KEEP_ALL history rejects further samples until some are taken. Only the
+    // transitions to full are counted, the rejected samples themselves are not notified.
+    if (history_limit_ > 0 && data_ >= history_limit_) {
+      if (!history_full_) {
+        ++history_became_full_count_;
+      }
+      history_full_ = true;
+    }
+
+    lock.unlock();
+    watermarks_->notify(crossing);
+  }
+
+  void
+  onNewMailboxMessage(eprosima::fastrtps::Subscriber * sub)
+  {
+    // the mailbox mutex is always locked before internalMutex_
+    std::lock_guard<std::mutex> mailbox_lock(mailbox_->mutex_);
+
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.is_cdr_buffer = true;
+    data.data = &mailbox_->buffer_;
+    eprosima::fastrtps::SampleInfo_t sinfo;
+    int64_t reception_time = rmw_fastrtps_shared_cpp::current_time_nanoseconds();
+    bool was_unread = mailbox_->unread_;
+    while (sub->takeNextData(&data, &sinfo)) {
+      RMW_FASTRTPS_TRACEPOINT(
+        mailbox_received, &sub->getGuid(), &sinfo.sample_identity.writer_guid(),
+        rmw_fastrtps_shared_cpp::sequence_number_to_int64(
+          sinfo.sample_identity.sequence_number()));
+      sample_loss_->sample_received(
+        sinfo.sample_identity.writer_guid(), sinfo.sample_identity.sequence_number());
+      if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
+        rate_->record(reception_time, data.cdr_length);
+        mailbox_->length_ = data.cdr_length;
+        mailbox_->sinfo_ = sinfo;
+        mailbox_->reception_time_ns_ = reception_time;
+        mailbox_->full_ = true;
+        mailbox_->unread_ = true;
+      }
+    }
+
+    // readiness only changes when a sample arrives while the slot had nothing unread
+    if (was_unread || !mailbox_->unread_) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(internalMutex_);
+    if (conditionMutex_ != nullptr) {
+      std::unique_lock<std::mutex> clock(*conditionMutex_);
+      data_ = 1;
+      clock.unlock();
+      conditionVariable_->notify_one();
+    } else {
+      data_ = 1;
+    }
+    counters_->set_backlog(1);
+    auto crossing = watermarks_->update(1);
+    lock.unlock();
+    watermarks_->notify(crossing);
+  }
+
+  /// Keep the reception times of a history of `samples` without allocating.
+  void
+  preallocate(size_t samples)
+  {
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    reception_times_.preallocate(samples);
   }
 
   void
@@ -101,10 +254,11 @@ public:
     return data_ > 0;
   }
 
-  void
+  // Return the reception time of the sample taken, zero when unknown
+  int64_t
   data_taken()
   {
-    std::lock_guard<std::mutex> lock(internalMutex_);
+    std::unique_lock<std::mutex> lock(internalMutex_);
 
     if (conditionMutex_ != nullptr) {
       std::unique_lock<std::mutex> clock(*conditionMutex_);
@@ -112,6 +266,17 @@ public:
     } else {
       --data_;
     }
+    counters_->set_backlog(data_);
+    auto crossing = watermarks_->update(data_);
+    if (data_ < history_limit_) {
+      history_full_ = false;
+    }
+
+    int64_t reception_time = 0;
+    reception_times_.pop(reception_time);
+    lock.unlock();
+    watermarks_->notify(crossing);
+    return reception_time;
   }
 
   size_t publisherCount()
@@ -120,9 +285,35 @@ public:
     return publishers_.size();
   }
 
+  // Number of times the history became full, not the number of samples it rejected
+  uint64_t historyBecameFullCount()
+  {
+    return history_became_full_count_.load();
+  }
+
+  // Estimated memory of the matched publishers and of the ring of reception times
+  size_t memoryFootprint()
+  {
+    constexpr size_t node_size =
+      sizeof(eprosima::fastrtps::rtps::GUID_t) + rmw_fastrtps_shared_cpp::tree_node_overhead;
+    std::lock_guard<std::mutex> lock(internalMutex_);
+    return publishers_.size() * node_size + reception_times_.memoryFootprint();
+  }
+
 private:
   std::mutex internalMutex_;
   std::atomic_size_t data_;
+  bool history_limit_known_;
+  size_t history_limit_;
+  // Whether the history was full at the last notification, guarded by internalMutex_
+  bool history_full_;
+  std::atomic<uint64_t> history_became_full_count_;
+  SubscriberMailbox * mailbox_;
+  rmw_fastrtps_shared_cpp::EntityCounters * counters_;
+  rmw_fastrtps_shared_cpp::SampleLossTracker * sample_loss_;
+  rmw_fastrtps_shared_cpp::BacklogWatermarks * watermarks_;
+  rmw_fastrtps_shared_cpp::RateCounters * rate_;
+  rmw_fastrtps_shared_cpp::ReceptionTimes reception_times_;
   std::mutex * conditionMutex_;
   std::condition_variable * conditionVariable_;
 
@@ -0,0 +1,117 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__DISCOVERY_COUNTERS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__DISCOVERY_COUNTERS_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of the discovery activity of the participant of a node.
+/**
+ * Remote participants and endpoints are counted every time they are discovered
+ * or removed, so a participant which restarts is counted twice.
+ * The graph triggers are the changes of the topic caches which woke up the graph
+ * guard condition, and the last change time tells when the caches were last updated,
+ * from which the convergence of discovery can be detected.
+ * The callback time is the time spent in the discovery callbacks of the listener.
+ */
+struct DiscoveryStatistics
+{
+  uint64_t participants_discovered;
+  uint64_t participants_removed;
+  uint64_t readers_discovered;
+  uint64_t readers_removed;
+  uint64_t writers_discovered;
+  uint64_t writers_removed;
+  uint64_t graph_triggers;
+  uint64_t callback_time_ns;
+  // Zero until the topic caches change for the first time
+  int64_t last_change_ns;
+};
+
+/// Discovery counters of a participant, updated without locking.
+class DiscoveryCounters
+{
+public:
+  DiscoveryCounters()
+  : participants_discovered_(0), participants_removed_(0),
+    readers_discovered_(0), readers_removed_(0), writers_discovered_(0), writers_removed_(0),
+    graph_triggers_(0), callback_time_ns_(0), last_change_ns_(0)
+  {
+  }
+
+  void
+  participant_discovered(bool is_alive)
+  {
+    (is_alive ? participants_discovered_ : participants_removed_).fetch_add(
+      1, std::memory_order_relaxed);
+  }
+
+  void
+  endpoint_discovered(bool is_reader, bool is_alive)
+  {
+    if (is_reader) {
+      (is_alive ? readers_discovered_ : readers_removed_).fetch_add(1, std::memory_order_relaxed);
+    } else {
+      (is_alive ? writers_discovered_ : writers_removed_).fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void
+  graph_changed(int64_t time_ns)
+  {
+    graph_triggers_.fetch_add(1, std::memory_order_relaxed);
+    last_change_ns_.store(time_ns, std::memory_order_relaxed);
+  }
+
+  void
+  callback_done(uint64_t time_ns)
+  {
+    callback_time_ns_.fetch_add(time_ns, std::memory_order_relaxed);
+  }
+
+  void
+  snapshot(DiscoveryStatistics & statistics) const
+  {
+    statistics.participants_discovered = participants_discovered_.load(std::memory_order_relaxed);
+    statistics.participants_removed = participants_removed_.load(std::memory_order_relaxed);
+    statistics.readers_discovered = readers_discovered_.load(std::memory_order_relaxed);
+    statistics.readers_removed = readers_removed_.load(std::memory_order_relaxed);
+    statistics.writers_discovered = writers_discovered_.load(std::memory_order_relaxed);
+    statistics.writers_removed = writers_removed_.load(std::memory_order_relaxed);
+    statistics.graph_triggers = graph_triggers_.load(std::memory_order_relaxed);
+    statistics.callback_time_ns = callback_time_ns_.load(std::memory_order_relaxed);
+    statistics.last_change_ns = last_change_ns_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> participants_discovered_;
+  std::atomic<uint64_t> participants_removed_;
+  std::atomic<uint64_t> readers_discovered_;
+  std::atomic<uint64_t> readers_removed_;
+  std::atomic<uint64_t> writers_discovered_;
+  std::atomic<uint64_t> writers_removed_;
+  std::atomic<uint64_t> graph_triggers_;
+  std::atomic<uint64_t> callback_time_ns_;
+  std::atomic<int64_t> last_change_ns_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__DISCOVERY_COUNTERS_HPP_
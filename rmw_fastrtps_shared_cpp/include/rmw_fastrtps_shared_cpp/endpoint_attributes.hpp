@@ -0,0 +1,148 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__ENDPOINT_ATTRIBUTES_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__ENDPOINT_ATTRIBUTES_HPP_
+
+#include "fastrtps/attributes/TopicAttributes.h"
+#include "fastrtps/qos/QosPolicies.h"
+#include "fastrtps/rtps/resources/ResourceManagement.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Return whether the writers of the given topic or service have the high priority class.
+/**
+ * \param[in] participant_info participant holding the priority configuration
+ * \param[in] topic_name ROS name of the topic or service
+ * \return `true` if the name is listed in RMW_FASTRTPS_HIGH_PRIORITY_TOPICS
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+is_high_priority_topic(const CustomParticipantInfo * participant_info, const char * topic_name);
+
+/// Return the Fast-RTPS publish mode to use for a writer of the given type.
+/**
+ * High priority writers are published synchronously from the caller's thread,
+ * so that their samples never queue behind the fragments of bulk samples in
+ * the asynchronous writer thread shared by the whole process. Synchronous
+ * writers cannot fragment, so this is only done for bounded types whose
+ * serialized size fits in a single RTPS message; other high priority writers
+ * keep the asynchronous writer, with a warning.
+ *
+ * With publishing_mode_t::SYNCHRONOUS, every writer is published synchronously
+ * under the same condition, and writers of other types keep the asynchronous
+ * writer, with a warning.
+ * With publishing_mode_t::AUTO, writers of bounded types whose serialized size
+ * fits in a single RTPS message are published synchronously as well, silently.
+ *
+ * Any other writer keeps using the asynchronous writer thread, which is
+ * required for fragmentation.
+ *
+ * \param[in] publishing_mode mode requested for the participant
+ * \param[in] high_priority whether the writer has the high priority class
+ * \param[in] type_support type support of the data written
+ * \return the publish mode kind to set in the publisher attributes
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+eprosima::fastrtps::PublishModeQosPolicyKind
+get_publish_mode(
+  publishing_mode_t publishing_mode,
+  bool high_priority,
+  const TypeSupport * type_support);
+
+/// Bound the resources of an endpoint history.
+/**
+ * KEEP_ALL histories hold at most RMW_FASTRTPS_KEEP_ALL_MAX_SAMPLES samples,
+ * or the QoS depth when that is not set, and preallocate at most
+ * RMW_FASTRTPS_KEEP_ALL_ALLOCATED_SAMPLES of them.
+ * Once full, writers fail to publish and readers stop accepting samples until
+ * some are taken, instead of growing without bound.
+ *
+ * KEEP_LAST histories are only given enough room for their depth.
+ *
+ * Call it once the QoS profile has been applied to the topic attributes.
+ *
+ * \param[in] participant_info participant holding the resource limits configuration
+ * \param[inout] topic topic attributes whose resource limits are set
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+set_resource_limits(
+  const CustomParticipantInfo * participant_info,
+  eprosima::fastrtps::TopicAttributes & topic);
+
+/// Return the number of samples a history holds at most, or zero when it is unlimited.
+/**
+ * That is the depth of KEEP_LAST histories, capped by their maximum samples, and the
+ * maximum samples of KEEP_ALL ones.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+int32_t
+get_history_samples(const eprosima::fastrtps::TopicAttributes & topic);
+
+/// Choose the history memory policy of an endpoint from its type and history.
+/**
+ * Bounded types whose whole KEEP_LAST history fits in a few megabytes are
+ * preallocated exactly, with one payload of the maximum serialized size per
+ * sample of the history depth.
+ *
+ * Shallow KEEP_LAST histories of unbounded types keep a pool of payloads which
+ * are reallocated when a bigger sample arrives.
+ *
+ * Any other history, including KEEP_ALL ones, allocates its payloads on demand
+ * and releases them once the samples are removed, so that its memory follows
+ * the actual backlog rather than the peak one.
+ *
+ * In zero allocation mode, every limited history is allocated at once instead,
+ * whatever its size, so that no payload is allocated once the endpoint is created.
+ *
+ * Call it once the QoS profile has been applied to the topic attributes.
+ *
+ * \param[in] participant_info participant of the endpoint, for its zero allocation mode
+ * \param[in] type_support type support of the data stored in the history
+ * \param[inout] topic topic attributes, whose allocated samples are adjusted
+ * \param[out] memory_policy memory policy to set in the endpoint attributes
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+set_history_memory_policy(
+  const CustomParticipantInfo * participant_info,
+  const TypeSupport * type_support,
+  eprosima::fastrtps::TopicAttributes & topic,
+  eprosima::fastrtps::rtps::MemoryManagementPolicy_t & memory_policy);
+
+/// Return the size of the payloads a history allocates at its creation.
+/**
+ * Preallocated histories allocate one payload of the maximum serialized size of the
+ * type per allocated sample, while histories allocating on demand start empty.
+ *
+ * \param[in] type_support type support of the data stored in the history
+ * \param[in] topic topic attributes of the endpoint
+ * \param[in] memory_policy memory policy of the endpoint
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+size_t
+get_preallocated_history_size(
+  const TypeSupport * type_support,
+  const eprosima::fastrtps::TopicAttributes & topic,
+  eprosima::fastrtps::rtps::MemoryManagementPolicy_t memory_policy);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__ENDPOINT_ATTRIBUTES_HPP_
@@ -0,0 +1,203 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__ENTITY_COUNTERS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__ENTITY_COUNTERS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+#include "time_utils.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of the counters of a publisher, subscription, service or client.
+/**
+ * Publishers and clients send messages, subscriptions and services take them,
+ * and services also send their responses while clients take them.
+ * The serialization and deserialization times are cumulative, and stay zero unless
+ * the conversions are timed through the RMW_FASTRTPS_CONVERSION_TIMING env variable.
+ * The backlog is the number of received messages not taken yet.
+ */
+struct EntityStatistics
+{
+  uint64_t messages_sent;
+  uint64_t bytes_sent;
+  uint64_t serialization_time_ns;
+  uint64_t messages_taken;
+  uint64_t bytes_taken;
+  uint64_t deserialization_time_ns;
+  uint64_t take_misses;
+  uint64_t backlog;
+  uint64_t peak_backlog;
+};
+
+/// Always-on counters of an entity, updated without locking.
+/**
+ * Only the conversions between ros messages and cdr are opt-in, as timing them
+ * reads the clock twice per message.
+ */
+class EntityCounters
+{
+public:
+  EntityCounters()
+  : messages_sent_(0), bytes_sent_(0), serialization_time_ns_(0),
+    messages_taken_(0), bytes_taken_(0), deserialization_time_ns_(0), take_misses_(0),
+    backlog_(0), peak_backlog_(0), conversion_timing_(false)
+  {
+  }
+
+  // Must be called before the entity sends or takes its first message
+  void
+  set_conversion_timing(bool conversion_timing)
+  {
+    conversion_timing_ = conversion_timing;
+  }
+
+  bool
+  times_conversions() const
+  {
+    return conversion_timing_;
+  }
+
+  /// Return the start of a conversion, only read from the clock when conversions are timed.
+  std::chrono::steady_clock::time_point
+  conversion_start() const
+  {
+    return conversion_timing_ ?
+           std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+  }
+
+  /// Return the time elapsed since conversion_start(), or 0 when conversions are not timed.
+  uint64_t
+  conversion_time_ns(const std::chrono::steady_clock::time_point & start) const
+  {
+    return conversion_timing_ ? elapsed_nanoseconds(start) : 0;
+  }
+
+  void
+  message_sent(size_t bytes, uint64_t serialization_time_ns)
+  {
+    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+    serialization_time_ns_.fetch_add(serialization_time_ns, std::memory_order_relaxed);
+  }
+
+  void
+  message_taken(size_t bytes, uint64_t deserialization_time_ns)
+  {
+    messages_taken_.fetch_add(1, std::memory_order_relaxed);
+    bytes_taken_.fetch_add(bytes, std::memory_order_relaxed);
+    deserialization_time_ns_.fetch_add(deserialization_time_ns, std::memory_order_relaxed);
+  }
+
+  void
+  take_missed()
+  {
+    take_misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Must be called with the lock guarding the backlog held
+  void
+  set_backlog(size_t backlog)
+  {
+    backlog_.store(backlog, std::memory_order_relaxed);
+    if (backlog > peak_backlog_.load(std::memory_order_relaxed)) {
+      peak_backlog_.store(backlog, std::memory_order_relaxed);
+    }
+  }
+
+  /// Add the counters to a snapshot, which sums them when aggregating several entities.
+  void
+  add_to(EntityStatistics & statistics) const
+  {
+    statistics.messages_sent += messages_sent_.load(std::memory_order_relaxed);
+    statistics.bytes_sent += bytes_sent_.load(std::memory_order_relaxed);
+    statistics.serialization_time_ns += serialization_time_ns_.load(std::memory_order_relaxed);
+    statistics.messages_taken += messages_taken_.load(std::memory_order_relaxed);
+    statistics.bytes_taken += bytes_taken_.load(std::memory_order_relaxed);
+    statistics.deserialization_time_ns +=
+      deserialization_time_ns_.load(std::memory_order_relaxed);
+    statistics.take_misses += take_misses_.load(std::memory_order_relaxed);
+    statistics.backlog += backlog_.load(std::memory_order_relaxed);
+    statistics.peak_backlog += peak_backlog_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> messages_sent_;
+  std::atomic<uint64_t> bytes_sent_;
+  std::atomic<uint64_t> serialization_time_ns_;
+  std::atomic<uint64_t> messages_taken_;
+  std::atomic<uint64_t> bytes_taken_;
+  std::atomic<uint64_t> deserialization_time_ns_;
+  std::atomic<uint64_t> take_misses_;
+  std::atomic<uint64_t> backlog_;
+  std::atomic<uint64_t> peak_backlog_;
+  bool conversion_timing_;
+};
+
+/// Counters of the entities created on a node, summed for the node statistics.
+class EntityCountersRegistry
+{
+public:
+  EntityCountersRegistry()
+  : conversion_timing_(false)
+  {
+  }
+
+  // Whether the entities added from now on time their conversions
+  void
+  set_conversion_timing(bool conversion_timing)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    conversion_timing_ = conversion_timing;
+  }
+
+  void
+  add(EntityCounters * counters)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters->set_conversion_timing(conversion_timing_);
+    counters_.insert(counters);
+  }
+
+  void
+  remove(const EntityCounters * counters)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.erase(counters);
+  }
+
+  void
+  add_to(EntityStatistics & statistics) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto counters : counters_) {
+      counters->add_to(statistics);
+    }
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::set<const EntityCounters *> counters_;
+  bool conversion_timing_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__ENTITY_COUNTERS_HPP_
@@ -0,0 +1,138 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__LATENCY_HISTOGRAM_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__LATENCY_HISTOGRAM_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of a latency histogram with power of two buckets.
+/**
+ * Bucket 0 counts the latencies below 1 microsecond, and bucket `i` those
+ * from 2^(i-1) up to 2^i microseconds, the last bucket also counting every
+ * larger latency. Negative latencies, caused by unsynchronized clocks, are
+ * counted in bucket 0 and in `negative_count`.
+ */
+struct LatencyHistogram
+{
+  static constexpr size_t bucket_count = 32;
+
+  uint64_t count;
+  uint64_t negative_count;
+  uint64_t sum_ns;
+  uint64_t max_ns;
+  uint64_t buckets[bucket_count];
+
+  /// Return an upper bound of the latency of the given fraction of the samples.
+  /**
+   * The bound is the upper limit of the bucket holding that fraction of the samples,
+   * capped by the maximum latency, so that benchmarks can report percentiles without
+   * keeping every sample. Zero is returned when the histogram is empty.
+   *
+   * \param[in] fraction fraction of the samples, in [0, 1], such as 0.99 for the 99th percentile
+   */
+  uint64_t
+  percentile_ns(double fraction) const
+  {
+    if (count == 0) {
+      return 0;
+    }
+    double rank = fraction * static_cast<double>(count);
+    uint64_t cumulated = 0;
+    for (size_t bucket = 0; bucket + 1 < bucket_count; ++bucket) {
+      cumulated += buckets[bucket];
+      if (static_cast<double>(cumulated) >= rank) {
+        uint64_t bound_ns = 1000ULL << bucket;
+        return bound_ns < max_ns ? bound_ns : max_ns;
+      }
+    }
+    return max_ns;
+  }
+};
+
+/// Latency histogram recorded without locking.
+class LatencyHistogramCounters
+{
+public:
+  LatencyHistogramCounters()
+  {
+    reset();
+  }
+
+  void
+  record(int64_t latency_ns)
+  {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    if (latency_ns < 0) {
+      negative_count_.fetch_add(1, std::memory_order_relaxed);
+      buckets_[0].fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    uint64_t latency = static_cast<uint64_t>(latency_ns);
+    sum_ns_.fetch_add(latency, std::memory_order_relaxed);
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (latency > max &&
+      !max_ns_.compare_exchange_weak(max, latency, std::memory_order_relaxed))
+    {
+    }
+    size_t bucket = 0;
+    for (uint64_t us = latency / 1000; us > 0 && bucket + 1 < LatencyHistogram::bucket_count;
+      us >>= 1)
+    {
+      ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Copy the histogram, concurrent records may be partially included.
+  void
+  snapshot(LatencyHistogram & histogram) const
+  {
+    histogram.count = count_.load(std::memory_order_relaxed);
+    histogram.negative_count = negative_count_.load(std::memory_order_relaxed);
+    histogram.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+    histogram.max_ns = max_ns_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LatencyHistogram::bucket_count; ++i) {
+      histogram.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  void
+  reset()
+  {
+    count_.store(0, std::memory_order_relaxed);
+    negative_count_.store(0, std::memory_order_relaxed);
+    sum_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+    for (auto & bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> negative_count_;
+  std::atomic<uint64_t> sum_ns_;
+  std::atomic<uint64_t> max_ns_;
+  std::atomic<uint64_t> buckets_[LatencyHistogram::bucket_count];
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__LATENCY_HISTOGRAM_HPP_
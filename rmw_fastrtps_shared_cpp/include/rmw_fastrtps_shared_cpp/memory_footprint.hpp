@@ -0,0 +1,77 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__MEMORY_FOOTPRINT_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__MEMORY_FOOTPRINT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Estimated memory attributed to a node or an entity.
+/**
+ * The estimates add up the size of the structures allocated by rmw_fastrtps and of the
+ * containers and buffers they own, without the overhead of the heap allocator.
+ * The history payloads are those preallocated at creation from the memory policy of
+ * the endpoints, while histories allocating on demand are not accounted for.
+ *
+ * The estimates are therefore lower bounds of the resident memory, off by:
+ * - the allocator overhead, in 64-bit glibc an 8 byte header per allocation whose size
+ *   is rounded up to 16 bytes and to at least 32, which adds up for small containers;
+ * - the readers, writers, proxies of matched endpoints and socket buffers of Fast RTPS,
+ *   which are sized by its own attributes rather than by the rmw entities;
+ * - the payloads of the histories allocating on demand, up to their depth times the
+ *   largest sample received or sent.
+ * The memory_footprint_benchmark of the rmw packages compares the estimates with the
+ * growth of the resident memory as entities are created.
+ */
+struct MemoryFootprint
+{
+  // Info structures and listeners, with the buffers and containers they hold
+  uint64_t entity_bytes;
+  // Payloads preallocated by the histories of the entity
+  uint64_t history_bytes;
+  // Only for nodes, the names and topics of the participants discovered by the node
+  uint64_t discovery_bytes;
+};
+
+/// Estimated memory attributed to a participant discovered by a node.
+struct PeerMemoryFootprint
+{
+  // GUID of the remote participant
+  uint8_t guid[16];
+  // Number of topic and type pairs of its readers and writers
+  uint64_t topic_count;
+  uint64_t bytes;
+};
+
+// Estimated size of the links of a node of an ordered, linked or hashed container,
+// besides its value.
+constexpr size_t tree_node_overhead = 4 * sizeof(void *);
+constexpr size_t list_node_overhead = 2 * sizeof(void *);
+constexpr size_t hash_node_overhead = 2 * sizeof(void *);
+
+/// Return the heap memory of a string, none when it fits in the string itself.
+inline size_t
+string_heap_size(const std::string & string)
+{
+  return string.capacity() > 15 ? string.capacity() + 1 : 0;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__MEMORY_FOOTPRINT_HPP_
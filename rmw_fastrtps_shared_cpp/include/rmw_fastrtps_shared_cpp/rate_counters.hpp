@@ -0,0 +1,201 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__RATE_COUNTERS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__RATE_COUNTERS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of the message rate, bandwidth and message sizes of a publisher or subscription.
+/**
+ * The rates are averaged over the last `window_ns` nanoseconds, which is at most
+ * one second, and shorter while the entity is younger than that. The sizes are
+ * those of the serialized messages, counted since the entity was created:
+ * bucket 0 counts the empty messages, and bucket `i` those from 2^(i-1) up to
+ * 2^i bytes, the last bucket also counting every larger message.
+ */
+struct RateStatistics
+{
+  static constexpr size_t size_bucket_count = 32;
+
+  uint64_t window_ns;
+  double messages_per_second;
+  double bytes_per_second;
+  uint64_t message_count;
+  uint64_t total_bytes;
+  uint64_t min_size;
+  uint64_t max_size;
+  uint64_t size_buckets[size_bucket_count];
+};
+
+/// Message rate over a sliding window of time slots, and message size distribution.
+/**
+ * Recorded without locking. Each slot packs the index of its time slot, truncated to
+ * its low `tag_bits` bits, with its count in one atomic word, so that moving a slot
+ * on to a new time slot and counting the message there is a single compare-exchange.
+ */
+class RateCounters
+{
+public:
+  static constexpr int64_t slot_ns = 100000000;
+  static constexpr size_t slot_count = 10;
+
+  RateCounters()
+  {
+    first_timestamp_ns_.store(0, std::memory_order_relaxed);
+    message_count_.store(0, std::memory_order_relaxed);
+    total_bytes_.store(0, std::memory_order_relaxed);
+    min_size_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_size_.store(0, std::memory_order_relaxed);
+    for (auto & bucket : size_buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    for (auto & slot : slots_) {
+      slot.messages.store(0, std::memory_order_relaxed);
+      slot.bytes.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void
+  record(int64_t timestamp_ns, size_t bytes)
+  {
+    size_t bucket = 0;
+    for (size_t size = bytes; size > 0 && bucket + 1 < RateStatistics::size_bucket_count;
+      size >>= 1)
+    {
+      ++bucket;
+    }
+
+    int64_t first = 0;
+    first_timestamp_ns_.compare_exchange_strong(first, timestamp_ns, std::memory_order_relaxed);
+    message_count_.fetch_add(1, std::memory_order_relaxed);
+    total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t min = min_size_.load(std::memory_order_relaxed);
+    while (bytes < min &&
+      !min_size_.compare_exchange_weak(min, bytes, std::memory_order_relaxed))
+    {
+    }
+    uint64_t max = max_size_.load(std::memory_order_relaxed);
+    while (bytes > max &&
+      !max_size_.compare_exchange_weak(max, bytes, std::memory_order_relaxed))
+    {
+    }
+    size_buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    int64_t index = timestamp_ns / slot_ns;
+    Slot & slot = slots_[static_cast<size_t>(index) % slot_count];
+    if (add(slot.messages, index, 1)) {
+      add(slot.bytes, index, bytes);
+    }
+  }
+
+  /// Copy the counters, concurrent records may be partially included.
+  void
+  snapshot(RateStatistics & statistics, int64_t now_ns) const
+  {
+    uint64_t message_count = message_count_.load(std::memory_order_relaxed);
+    statistics.message_count = message_count;
+    statistics.total_bytes = total_bytes_.load(std::memory_order_relaxed);
+    uint64_t min_size = min_size_.load(std::memory_order_relaxed);
+    statistics.min_size = UINT64_MAX == min_size ? 0 : min_size;
+    statistics.max_size = max_size_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < RateStatistics::size_bucket_count; ++i) {
+      statistics.size_buckets[i] = size_buckets_[i].load(std::memory_order_relaxed);
+    }
+
+    int64_t current = now_ns / slot_ns;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    for (size_t age = 0; age < slot_count; ++age) {
+      int64_t index = current - static_cast<int64_t>(age);
+      const Slot & slot = slots_[static_cast<size_t>(index) % slot_count];
+      messages += count(slot.messages, index);
+      bytes += count(slot.bytes, index);
+    }
+    int64_t window = static_cast<int64_t>(slot_count - 1) * slot_ns + now_ns % slot_ns;
+    if (message_count > 0) {
+      window = std::min(window, now_ns - first_timestamp_ns_.load(std::memory_order_relaxed));
+    }
+    statistics.window_ns = window > 0 ? static_cast<uint64_t>(window) : 0;
+    statistics.messages_per_second = window > 0 ? messages * 1e9 / window : 0.0;
+    statistics.bytes_per_second = window > 0 ? bytes * 1e9 / window : 0.0;
+  }
+
+private:
+  // a tag wraps around every 2^24 slots, more than 19 days
+  static constexpr unsigned tag_bits = 24;
+  static constexpr unsigned count_bits = 64 - tag_bits;
+  static constexpr uint64_t count_mask = (1ULL << count_bits) - 1;
+  static constexpr uint64_t tag_mask = (1ULL << tag_bits) - 1;
+  // a record is at most that many slots later than the most recent one
+  static constexpr uint64_t late_slot_limit = 1024;
+
+  struct Slot
+  {
+    std::atomic<uint64_t> messages;
+    std::atomic<uint64_t> bytes;
+  };
+
+  // Add to the count of a slot, restarting it from zero when it is empty or holds an older
+  // time slot. Return false, without adding, when it already holds a newer one.
+  static bool
+  add(std::atomic<uint64_t> & word, int64_t index, uint64_t amount)
+  {
+    uint64_t tag = static_cast<uint64_t>(index) & tag_mask;
+    uint64_t old = word.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t old_tag = old >> count_bits;
+      uint64_t value = amount;
+      if (old_tag == tag) {
+        value += old & count_mask;
+      } else if ((old & count_mask) != 0 && ((old_tag - tag) & tag_mask) <= late_slot_limit) {
+        // too old to be in the window anymore
+        return false;
+      }
+      // the count saturates instead of overflowing into the tag
+      value = value < count_mask ? value : count_mask;
+      if (word.compare_exchange_weak(old, (tag << count_bits) | value, std::memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+  }
+
+  // Return the count of a slot if it holds that time slot
+  static uint64_t
+  count(const std::atomic<uint64_t> & word, int64_t index)
+  {
+    uint64_t value = word.load(std::memory_order_relaxed);
+    uint64_t tag = static_cast<uint64_t>(index) & tag_mask;
+    return (value >> count_bits) == tag ? value & count_mask : 0;
+  }
+
+  std::atomic<int64_t> first_timestamp_ns_;
+  std::atomic<uint64_t> message_count_;
+  std::atomic<uint64_t> total_bytes_;
+  std::atomic<uint64_t> min_size_;
+  std::atomic<uint64_t> max_size_;
+  std::atomic<uint64_t> size_buckets_[RateStatistics::size_bucket_count];
+  Slot slots_[slot_count];
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__RATE_COUNTERS_HPP_
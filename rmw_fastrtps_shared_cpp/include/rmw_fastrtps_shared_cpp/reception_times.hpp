@@ -0,0 +1,109 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__RECEPTION_TIMES_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__RECEPTION_TIMES_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Reception times of the samples of a subscription not taken yet, oldest first.
+/**
+ * The times are kept in a ring, which grows with the backlog by default. Once preallocated
+ * for the depth of the history, which the backlog cannot exceed, the ring never grows, so
+ * that receiving and taking samples does not allocate. Not thread safe.
+ */
+class ReceptionTimes
+{
+public:
+  ReceptionTimes()
+  : head_(0), size_(0), fixed_(false)
+  {
+  }
+
+  /// Allocate room for `capacity` times, and drop the oldest time instead of growing.
+  void
+  preallocate(size_t capacity)
+  {
+    if (capacity > times_.size()) {
+      resize(capacity);
+    }
+    fixed_ = capacity > 0;
+  }
+
+  /// Record a reception, then drop the oldest times beyond the `backlog` unread samples.
+  void
+  push(int64_t time, size_t backlog)
+  {
+    if (size_ == times_.size()) {
+      if (fixed_) {
+        int64_t oldest;
+        pop(oldest);
+      } else {
+        resize(times_.empty() ? 16 : 2 * times_.size());
+      }
+    }
+    times_[(head_ + size_) % times_.size()] = time;
+    ++size_;
+    int64_t dropped;
+    while (size_ > backlog && pop(dropped)) {
+    }
+  }
+
+  /// Remove the oldest time, return false if there is none.
+  bool
+  pop(int64_t & time)
+  {
+    if (size_ == 0) {
+      return false;
+    }
+    time = times_[head_];
+    head_ = (head_ + 1) % times_.size();
+    --size_;
+    return true;
+  }
+
+  /// Return the memory held by the ring.
+  size_t
+  memoryFootprint() const
+  {
+    return times_.capacity() * sizeof(int64_t);
+  }
+
+private:
+  void
+  resize(size_t capacity)
+  {
+    std::vector<int64_t> times(capacity);
+    for (size_t i = 0; i < size_; ++i) {
+      times[i] = times_[(head_ + i) % times_.size()];
+    }
+    times_.swap(times);
+    head_ = 0;
+  }
+
+  std::vector<int64_t> times_;
+  size_t head_;
+  size_t size_;
+  bool fixed_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__RECEPTION_TIMES_HPP_
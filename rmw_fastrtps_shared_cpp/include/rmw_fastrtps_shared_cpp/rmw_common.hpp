@@ -15,7 +15,15 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__RMW_COMMON_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__RMW_COMMON_HPP_
 
+#include "./discovery_counters.hpp"
+#include "./entity_counters.hpp"
+#include "./latency_histogram.hpp"
+#include "./memory_footprint.hpp"
+#include "./rate_counters.hpp"
+#include "./sample_loss.hpp"
+#include "./taken_sample_info.hpp"
 #include "./visibility_control.h"
+#include "./wait_set_counters.hpp"
 
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
@@ -63,6 +71,219 @@ __rmw_get_gid_for_publisher(
   const rmw_publisher_t * publisher,
   rmw_gid_t * gid);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_publisher_history_overflow_count(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  uint64_t * count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_history_overflow_count(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  uint64_t * count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_expired_sample_count(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  uint64_t * count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_publisher_statistics(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  EntityStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_statistics(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  EntityStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_service_statistics(
+  const char * identifier,
+  const rmw_service_t * service,
+  EntityStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_client_statistics(
+  const char * identifier,
+  const rmw_client_t * client,
+  EntityStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_node_statistics(
+  const char * identifier,
+  const rmw_node_t * node,
+  EntityStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_node_discovery_statistics(
+  const char * identifier,
+  const rmw_node_t * node,
+  DiscoveryStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_wait_set_statistics(
+  const char * identifier,
+  const rmw_wait_set_t * wait_set,
+  WaitSetStatistics * statistics,
+  LatencyHistogram * overhead);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_publisher_memory_footprint(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  MemoryFootprint * footprint);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_memory_footprint(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  MemoryFootprint * footprint);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_service_memory_footprint(
+  const char * identifier,
+  const rmw_service_t * service,
+  MemoryFootprint * footprint);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_client_memory_footprint(
+  const char * identifier,
+  const rmw_client_t * client,
+  MemoryFootprint * footprint);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_node_memory_footprint(
+  const char * identifier,
+  const rmw_node_t * node,
+  MemoryFootprint * footprint);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_node_peer_memory_footprints(
+  const char * identifier,
+  const rmw_node_t * node,
+  PeerMemoryFootprint * footprints,
+  size_t capacity,
+  size_t * count);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_latency_histograms(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  LatencyHistogram * transport_latency,
+  LatencyHistogram * queueing_latency);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_reset_subscription_latency_histograms(
+  const char * identifier,
+  const rmw_subscription_t * subscription);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_client_round_trip_latency(
+  const char * identifier,
+  const rmw_client_t * client,
+  LatencyHistogram * round_trip_latency);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_reset_client_round_trip_latency(
+  const char * identifier,
+  const rmw_client_t * client);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_publisher_rate_statistics(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  RateStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_rate_statistics(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  RateStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_sample_loss(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  SampleLossStatistics * statistics);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_set_subscription_sample_loss_alarm(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  double loss_ratio,
+  size_t window,
+  const rmw_guard_condition_t * guard_condition);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_set_subscription_backlog_watermarks(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_set_service_backlog_watermarks(
+  const char * identifier,
+  const rmw_service_t * service,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_subscription_taken_sample_info(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  TakenSampleInfo * sample_info);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_service_taken_request_info(
+  const char * identifier,
+  const rmw_service_t * service,
+  TakenSampleInfo * sample_info);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_get_client_taken_response_info(
+  const char * identifier,
+  const rmw_client_t * client,
+  TakenSampleInfo * sample_info);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_guard_condition_t *
 __rmw_create_guard_condition(const char * identifier);
@@ -254,6 +475,15 @@ __rmw_take_with_info(
   bool * taken,
   rmw_message_info_t * message_info);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_read_latest(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_take_serialized_message(
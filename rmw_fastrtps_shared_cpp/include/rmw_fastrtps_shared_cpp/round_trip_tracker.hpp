@@ -0,0 +1,104 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__ROUND_TRIP_TRACKER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__ROUND_TRIP_TRACKER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "rmw_fastrtps_shared_cpp/latency_histogram.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Round trip latency of the requests of a client.
+/**
+ * The latency goes from the sending of a request to the reception of its response.
+ * The sending time of the last `slot_count` requests is kept in a fixed array indexed
+ * by sequence number, so that tracking never allocates. The response of an older
+ * request, or of a request sent before a reset, is not recorded.
+ */
+class RoundTripTracker
+{
+public:
+  static constexpr size_t slot_count = 1024;
+
+  RoundTripTracker()
+  {
+    reset();
+  }
+
+  void
+  request_sent(int64_t sequence_number, int64_t time_ns)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot & slot = slots_[static_cast<uint64_t>(sequence_number) % slot_count];
+    slot.sequence_number = sequence_number;
+    slot.sent_ns = time_ns;
+  }
+
+  void
+  response_received(int64_t sequence_number, int64_t time_ns)
+  {
+    int64_t sent_ns;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Slot & slot = slots_[static_cast<uint64_t>(sequence_number) % slot_count];
+      if (slot.sequence_number != sequence_number) {
+        return;
+      }
+      sent_ns = slot.sent_ns;
+      // a duplicate response is only recorded once
+      slot.sequence_number = -1;
+    }
+    latency_.record(time_ns - sent_ns);
+  }
+
+  void
+  snapshot(LatencyHistogram & histogram) const
+  {
+    latency_.snapshot(histogram);
+  }
+
+  void
+  reset()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto & slot : slots_) {
+        slot.sequence_number = -1;
+        slot.sent_ns = 0;
+      }
+    }
+    latency_.reset();
+  }
+
+private:
+  struct Slot
+  {
+    int64_t sequence_number;
+    int64_t sent_ns;
+  };
+
+  std::mutex mutex_;
+  Slot slots_[slot_count];
+  LatencyHistogramCounters latency_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__ROUND_TRIP_TRACKER_HPP_
@@ -0,0 +1,162 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__SAMPLE_LOSS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__SAMPLE_LOSS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "fastrtps/rtps/common/Guid.h"
+#include "fastrtps/rtps/common/SequenceNumber.h"
+
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of the sample loss of a subscription, summed over its matched writers.
+/**
+ * A sample is lost when a later sequence number of the same writer is received
+ * before it. Samples sent before the first one received from a writer are not
+ * counted, and neither are the ones a writer sends after the last received.
+ * The loss alarm count is the number of windows whose loss ratio reached the
+ * alarm threshold.
+ */
+struct SampleLossStatistics
+{
+  uint64_t received;
+  uint64_t lost;
+  uint64_t out_of_order;
+  uint64_t loss_alarms;
+};
+
+/// Sequence number gap detection over the samples received from every writer.
+class SampleLossTracker
+{
+public:
+  SampleLossTracker()
+  : received_(0), lost_(0), out_of_order_(0), loss_alarms_(0),
+    alarm_threshold_(0.0), alarm_window_(0), window_expected_(0), window_lost_(0)
+  {
+  }
+
+  void
+  sample_received(
+    const eprosima::fastrtps::rtps::GUID_t & writer_guid,
+    const eprosima::fastrtps::rtps::SequenceNumber_t & sequence_number)
+  {
+    int64_t sequence = sequence_number_to_int64(sequence_number);
+    std::function<void()> alarm;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++received_;
+      auto it = last_sequence_numbers_.find(writer_guid);
+      if (it == last_sequence_numbers_.end()) {
+        last_sequence_numbers_.emplace(writer_guid, sequence);
+        return;
+      }
+      if (sequence <= it->second) {
+        // a sample counted as lost finally arrived, or a duplicate
+        ++out_of_order_;
+        return;
+      }
+      uint64_t gap = static_cast<uint64_t>(sequence - it->second - 1);
+      it->second = sequence;
+      lost_ += gap;
+
+      if (alarm_window_ == 0) {
+        return;
+      }
+      window_expected_ += gap + 1;
+      window_lost_ += gap;
+      if (window_expected_ < alarm_window_) {
+        return;
+      }
+      if (static_cast<double>(window_lost_) >= alarm_threshold_ * window_expected_) {
+        ++loss_alarms_;
+        alarm = on_alarm_;
+      }
+      window_expected_ = 0;
+      window_lost_ = 0;
+    }
+    // called unlocked, it may lock the wait set
+    if (alarm) {
+      alarm();
+    }
+  }
+
+  void
+  writer_removed(const eprosima::fastrtps::rtps::GUID_t & writer_guid)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_sequence_numbers_.erase(writer_guid);
+  }
+
+  /// Call `on_alarm` for every `window` expected samples of which a `threshold` ratio is lost.
+  /**
+   * A zero window disables the alarm.
+   */
+  void
+  set_alarm(double threshold, size_t window, std::function<void()> on_alarm)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    alarm_threshold_ = threshold;
+    alarm_window_ = window;
+    on_alarm_ = std::move(on_alarm);
+    window_expected_ = 0;
+    window_lost_ = 0;
+  }
+
+  void
+  snapshot(SampleLossStatistics & statistics) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics.received = received_;
+    statistics.lost = lost_;
+    statistics.out_of_order = out_of_order_;
+    statistics.loss_alarms = loss_alarms_;
+  }
+
+  /// Return the estimated memory of the sequence numbers kept per matched writer.
+  size_t
+  memory_footprint() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_sequence_numbers_.size() *
+           (sizeof(eprosima::fastrtps::rtps::GUID_t) + sizeof(int64_t) + tree_node_overhead);
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::map<eprosima::fastrtps::rtps::GUID_t, int64_t> last_sequence_numbers_;
+  uint64_t received_;
+  uint64_t lost_;
+  uint64_t out_of_order_;
+  uint64_t loss_alarms_;
+  double alarm_threshold_;
+  size_t alarm_window_;
+  uint64_t window_expected_;
+  uint64_t window_lost_;
+  std::function<void()> on_alarm_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__SAMPLE_LOSS_HPP_
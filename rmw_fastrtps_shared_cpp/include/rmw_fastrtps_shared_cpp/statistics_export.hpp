@@ -0,0 +1,197 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__STATISTICS_EXPORT_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__STATISTICS_EXPORT_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/discovery_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/entity_counters.hpp"
+#include "rmw_fastrtps_shared_cpp/latency_histogram.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+struct CustomClientInfo;
+struct CustomPublisherInfo;
+struct CustomServiceInfo;
+struct CustomSubscriberInfo;
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+// Layout of the statistics file of a process, "rmw_fastrtps_<pid>.stats" in the directory
+// given by the RMW_FASTRTPS_STATISTICS_EXPORT_DIR env variable.
+//
+// The file starts with a StatisticsExportHeader, followed by `record_capacity` records of
+// `record_size` bytes. Readers must check the magic and version, and use the sizes from the
+// header rather than their own, so that fields can be appended in later versions.
+//
+// Each record is guarded by a sequence lock: a reader copies the record, and only uses the
+// copy when its sequence was even and unchanged before and after the copy. A record whose
+// kind is STATISTICS_EXPORT_FREE is unused. The file is removed when the process shuts down.
+
+constexpr char statistics_export_magic[8] = {'R', 'M', 'W', 'F', 'R', 'T', 'P', 'S'};
+constexpr uint32_t statistics_export_version = 1;
+
+enum StatisticsExportKind : uint32_t
+{
+  STATISTICS_EXPORT_FREE = 0,
+  STATISTICS_EXPORT_NODE = 1,
+  STATISTICS_EXPORT_PUBLISHER = 2,
+  STATISTICS_EXPORT_SUBSCRIPTION = 3,
+  STATISTICS_EXPORT_SERVICE = 4,
+  STATISTICS_EXPORT_CLIENT = 5
+};
+
+struct StatisticsExportHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t record_size;
+  uint32_t record_capacity;
+  uint64_t pid;
+  int64_t period_ns;
+  // Incremented after every update of the records, with the time of the last one
+  std::atomic<uint64_t> update_count;
+  std::atomic<int64_t> last_update_ns;
+};
+
+struct StatisticsExportRecord
+{
+  std::atomic<uint64_t> sequence;
+  uint32_t kind;
+  uint32_t reserved;
+  // Fully qualified name of the node, and name of the topic or service of an entity
+  char node_name[128];
+  char name[256];
+  // For nodes, the sum of the counters of their entities
+  EntityStatistics statistics;
+  // Only for subscriptions
+  LatencyHistogram transport_latency;
+  LatencyHistogram queueing_latency;
+  // Only for nodes, the remote participants and the topics discovered by their participant
+  uint64_t discovered_participants;
+  uint64_t discovered_reader_topics;
+  uint64_t discovered_writer_topics;
+  // Only for nodes, the discovery activity of their participant
+  DiscoveryStatistics discovery;
+  // Only for clients
+  LatencyHistogram round_trip_latency;
+};
+
+/// Periodic copy of the statistics of every exported entity of the process into a mapped file.
+/**
+ * The copy is done by a thread of its own, so neither the publish nor the take paths
+ * make any additional system call, and no DDS traffic is involved.
+ */
+class StatisticsExporter
+{
+public:
+  using Fill = std::function<void(StatisticsExportRecord &)>;
+
+  /// Return the exporter of the process, creating it if needed, or null when it cannot be.
+  /**
+   * The directory and period are those of the first call, while the exporter lives.
+   */
+  static std::shared_ptr<StatisticsExporter>
+  get_instance(const std::string & directory, int64_t period_ns, size_t record_capacity);
+
+  ~StatisticsExporter();
+
+  /// Export the statistics of an entity, filled in from the exporter thread.
+  void
+  add(
+    const void * entity, StatisticsExportKind kind,
+    const std::string & node_name, const std::string & name, Fill fill);
+
+  /// Stop exporting an entity, once this returns its fill function is not called anymore.
+  void
+  remove(const void * entity);
+
+private:
+  StatisticsExporter(
+    const std::string & path, void * mapping, size_t size, int64_t period_ns,
+    size_t record_capacity);
+
+  StatisticsExportRecord *
+  record(size_t index);
+
+  void
+  run();
+
+  struct Entry
+  {
+    size_t index;
+    Fill fill;
+  };
+
+  std::string path_;
+  void * mapping_;
+  size_t size_;
+  StatisticsExportHeader * header_;
+  int64_t period_ns_;
+
+  std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  bool stop_;
+  std::map<const void *, Entry> entries_;
+  std::vector<size_t> free_indexes_;
+  std::thread thread_;
+};
+
+// Register the statistics of a node or an entity with the exporter of its node, if any.
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+export_node_statistics(const rmw_node_t * node);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+export_publisher_statistics(
+  const rmw_node_t * node, const CustomPublisherInfo * info, const char * topic_name);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+export_subscription_statistics(
+  const rmw_node_t * node, const CustomSubscriberInfo * info, const char * topic_name);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+export_service_statistics(
+  const rmw_node_t * node, const CustomServiceInfo * info, const char * service_name);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+export_client_statistics(
+  const rmw_node_t * node, const CustomClientInfo * info, const char * service_name);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+unexport_statistics(const rmw_node_t * node, const void * entity);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__STATISTICS_EXPORT_HPP_
@@ -0,0 +1,39 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__TAKEN_SAMPLE_INFO_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__TAKEN_SAMPLE_INFO_HPP_
+
+#include <cstdint>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Timestamps and sequence number of the last sample taken by an entity.
+/**
+ * Timestamps are in nanoseconds since the epoch of the system clock.
+ * The source timestamp is set by the writer, on its host clock.
+ * The reception timestamp is zero when the reception time is not known.
+ * The sequence number is the one assigned by the writer to the sample.
+ */
+struct TakenSampleInfo
+{
+  int64_t source_timestamp_ns;
+  int64_t reception_timestamp_ns;
+  int64_t sequence_number;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__TAKEN_SAMPLE_INFO_HPP_
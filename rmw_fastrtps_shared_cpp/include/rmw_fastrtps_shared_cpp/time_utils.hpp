@@ -0,0 +1,52 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__TIME_UTILS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__TIME_UTILS_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+#include "fastrtps/rtps/common/Time_t.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Convert a Fast-RTPS time or duration, whose fraction is in units of 1/2^32 seconds.
+inline int64_t
+time_to_nanoseconds(const eprosima::fastrtps::rtps::Time_t & time)
+{
+  return static_cast<int64_t>(time.seconds) * 1000000000LL +
+         static_cast<int64_t>((static_cast<uint64_t>(time.fraction) * 1000000000ULL) >> 32);
+}
+
+/// Return the current time on the clock Fast-RTPS stamps the samples with.
+inline int64_t
+current_time_nanoseconds()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/// Return the time elapsed since a point on the steady clock.
+inline uint64_t
+elapsed_nanoseconds(const std::chrono::steady_clock::time_point & start)
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now() - start).count());
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__TIME_UTILS_HPP_
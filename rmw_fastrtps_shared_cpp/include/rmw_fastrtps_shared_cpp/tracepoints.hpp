@@ -0,0 +1,47 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__TRACEPOINTS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__TRACEPOINTS_HPP_
+
+#include <cstdint>
+
+#include "fastrtps/rtps/common/SequenceNumber.h"
+
+// Static tracepoints, only compiled in when the RMW_FASTRTPS_TRACEPOINTS CMake option is on.
+// They are USDT probes of the rmw_fastrtps provider, which cost a single nop until a tracer
+// such as bpftrace, SystemTap or LTTng attaches to them. When compiled out, their arguments
+// are not even evaluated.
+//
+// Entities are identified by a pointer to their 16 bytes GUID, and samples by the GUID of
+// their writer and their sequence number, so that a sample can be followed across processes.
+#ifdef RMW_FASTRTPS_TRACEPOINTS_ENABLED
+#include <sys/sdt.h>
+#define RMW_FASTRTPS_TRACEPOINT(name, ...) STAP_PROBEV(rmw_fastrtps, name, __VA_ARGS__)
+#else
+#define RMW_FASTRTPS_TRACEPOINT(name, ...)
+#endif
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+inline int64_t
+sequence_number_to_int64(const eprosima::fastrtps::rtps::SequenceNumber_t & sequence_number)
+{
+  return (static_cast<int64_t>(sequence_number.high) << 32) | sequence_number.low;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__TRACEPOINTS_HPP_
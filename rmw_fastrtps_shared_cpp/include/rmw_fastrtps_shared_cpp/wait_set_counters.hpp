@@ -0,0 +1,105 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__WAIT_SET_COUNTERS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__WAIT_SET_COUNTERS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "rmw_fastrtps_shared_cpp/latency_histogram.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Snapshot of the counters of a wait set.
+/**
+ * Every call to wait either finds an entity ready right away, blocks until one
+ * is or until the timeout. The blocked time is spent waiting on the condition
+ * variable, while the overhead is the rest of the call: attaching the entities,
+ * checking them, and detaching them, which grows with the number of attached entities.
+ * The attached and ready entities are those of the last call.
+ */
+struct WaitSetStatistics
+{
+  uint64_t wait_count;
+  uint64_t blocked_count;
+  uint64_t timeout_count;
+  uint64_t blocked_time_ns;
+  uint64_t overhead_time_ns;
+  uint64_t attached_count;
+  uint64_t ready_count;
+};
+
+/// Counters of a wait set, updated without locking.
+class WaitSetCounters
+{
+public:
+  WaitSetCounters()
+  : wait_count_(0), blocked_count_(0), timeout_count_(0), blocked_time_ns_(0),
+    overhead_time_ns_(0), attached_count_(0), ready_count_(0)
+  {
+  }
+
+  void
+  wait_done(
+    size_t attached_count, size_t ready_count, bool blocked, bool timeout,
+    uint64_t blocked_time_ns, uint64_t overhead_time_ns)
+  {
+    wait_count_.fetch_add(1, std::memory_order_relaxed);
+    if (blocked) {
+      blocked_count_.fetch_add(1, std::memory_order_relaxed);
+      blocked_time_ns_.fetch_add(blocked_time_ns, std::memory_order_relaxed);
+    }
+    if (timeout) {
+      timeout_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    overhead_time_ns_.fetch_add(overhead_time_ns, std::memory_order_relaxed);
+    attached_count_.store(attached_count, std::memory_order_relaxed);
+    ready_count_.store(ready_count, std::memory_order_relaxed);
+    overhead_.record(static_cast<int64_t>(overhead_time_ns));
+  }
+
+  void
+  snapshot(WaitSetStatistics & statistics, LatencyHistogram * overhead) const
+  {
+    statistics.wait_count = wait_count_.load(std::memory_order_relaxed);
+    statistics.blocked_count = blocked_count_.load(std::memory_order_relaxed);
+    statistics.timeout_count = timeout_count_.load(std::memory_order_relaxed);
+    statistics.blocked_time_ns = blocked_time_ns_.load(std::memory_order_relaxed);
+    statistics.overhead_time_ns = overhead_time_ns_.load(std::memory_order_relaxed);
+    statistics.attached_count = attached_count_.load(std::memory_order_relaxed);
+    statistics.ready_count = ready_count_.load(std::memory_order_relaxed);
+    if (overhead) {
+      overhead_.snapshot(*overhead);
+    }
+  }
+
+private:
+  std::atomic<uint64_t> wait_count_;
+  std::atomic<uint64_t> blocked_count_;
+  std::atomic<uint64_t> timeout_count_;
+  std::atomic<uint64_t> blocked_time_ns_;
+  std::atomic<uint64_t> overhead_time_ns_;
+  std::atomic<uint64_t> attached_count_;
+  std::atomic<uint64_t> ready_count_;
+  // Distribution of the overhead of the calls
+  LatencyHistogramCounters overhead_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__WAIT_SET_COUNTERS_HPP_
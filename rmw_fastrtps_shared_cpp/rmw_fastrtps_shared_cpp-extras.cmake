@@ -22,3 +22,8 @@ find_package(FastRTPS REQUIRED MODULE)
 list(APPEND rmw_fastrtps_shared_cpp_INCLUDE_DIRS ${FastRTPS_INCLUDE_DIR})
 # specific order: dependents before dependencies
 list(APPEND rmw_fastrtps_shared_cpp_LIBRARIES fastrtps fastcdr)
+
+# sources of the benchmarks, which each rmw implementation builds against its library
+set(rmw_fastrtps_shared_cpp_BENCHMARK_DIR "${rmw_fastrtps_shared_cpp_DIR}/../benchmark")
+# sources of the tests shared by the rmw implementations, built the same way
+set(rmw_fastrtps_shared_cpp_TEST_DIR "${rmw_fastrtps_shared_cpp_DIR}/../test")
@@ -15,9 +15,12 @@
 #include <fastcdr/FastBuffer.h>
 #include <fastcdr/Cdr.h>
 #include <cassert>
+#include <chrono>
 #include <string>
 #include <vector>
 
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
@@ -54,9 +57,14 @@ bool TypeSupport::serialize(
       payload->encapsulation = ser->endianness() ==
         eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
       memcpy(payload->data, ser->getBufferPointer(), ser->getSerializedDataLength());
+      ser_data->cdr_length = payload->length;
+      ser_data->conversion_time_ns = 0;
       return true;
     }
   } else {
+    // the clock is only read when the conversions are timed
+    auto start = ser_data->time_conversion ?
+      std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
     eprosima::fastcdr::FastBuffer fastbuffer(
       reinterpret_cast<char *>(payload->data),
       payload->max_size);  // Object that manages the raw buffer.
@@ -66,6 +74,10 @@ bool TypeSupport::serialize(
       payload->encapsulation = ser.endianness() ==
         eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
       payload->length = (uint32_t)ser.getSerializedDataLength();
+      ser_data->cdr_length = payload->length;
+      ser_data->conversion_time_ns = ser_data->time_conversion ? elapsed_nanoseconds(start) : 0;
+      RMW_FASTRTPS_TRACEPOINT(
+        serialize, getName(), ser_data->data, payload->length, ser_data->conversion_time_ns);
       return true;
     }
   }
@@ -83,13 +95,25 @@ bool TypeSupport::deserialize(
   auto ser_data = static_cast<SerializedData *>(data);
   if (ser_data->is_cdr_buffer) {
     auto buffer = static_cast<eprosima::fastcdr::FastBuffer *>(ser_data->data);
-    if (!buffer->reserve(payload->length)) {
-      return false;
+    // a buffer which already holds a sample is overwritten in place when large enough
+    size_t capacity = buffer->getBufferSize();
+    if (capacity == 0) {
+      if (!buffer->reserve(payload->length)) {
+        return false;
+      }
+    } else if (capacity < payload->length) {
+      if (!buffer->resize(payload->length - capacity)) {
+        return false;
+      }
     }
     memcpy(buffer->getBuffer(), payload->data, payload->length);
+    ser_data->cdr_length = payload->length;
+    ser_data->conversion_time_ns = 0;
     return true;
   }
 
+  auto start = ser_data->time_conversion ?
+    std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
   eprosima::fastcdr::FastBuffer fastbuffer(
     reinterpret_cast<char *>(payload->data),
     payload->length);
@@ -97,7 +121,12 @@ bool TypeSupport::deserialize(
     fastbuffer,
     eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
     eprosima::fastcdr::Cdr::DDS_CDR);
-  return deserializeROSmessage(deser, ser_data->data);
+  bool ret = deserializeROSmessage(deser, ser_data->data);
+  ser_data->cdr_length = payload->length;
+  ser_data->conversion_time_ns = ser_data->time_conversion ? elapsed_nanoseconds(start) : 0;
+  RMW_FASTRTPS_TRACEPOINT(
+    deserialize, getName(), ser_data->data, payload->length, ser_data->conversion_time_ns);
+  return ret;
 }
 
 std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(void * data)
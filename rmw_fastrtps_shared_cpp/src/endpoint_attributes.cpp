@@ -0,0 +1,209 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fastrtps/qos/QosPolicies.h"
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/endpoint_attributes.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+// Largest serialized payload which fits in a single RTPS DATA submessage on the default
+// UDPv4 transport (65500 bytes per datagram) once the RTPS headers have been accounted for.
+// Synchronous writers cannot fragment, so bigger payloads need the asynchronous writer.
+static const uint32_t max_unfragmented_payload_size = 64000;
+
+// Largest history which is fully preallocated for a bounded type.
+// Bigger histories allocate their payloads on demand instead.
+static const uint64_t max_preallocated_history_size = 8 * 1024 * 1024;
+
+// Largest number of samples of an unbounded type kept in a reallocating pool.
+// Every pooled payload keeps the size of the biggest sample it ever held,
+// so deeper histories of unbounded types release their payloads instead.
+static const int32_t max_reallocated_history_samples = 16;
+
+static bool
+fits_unfragmented(const TypeSupport * type_support)
+{
+  return type_support && type_support->is_bounded() &&
+         type_support->m_typeSize <= max_unfragmented_payload_size;
+}
+
+bool
+is_high_priority_topic(const CustomParticipantInfo * participant_info, const char * topic_name)
+{
+  if (!participant_info || !topic_name) {
+    return false;
+  }
+  const auto & topics = participant_info->high_priority_topics;
+  return topics.find(topic_name) != topics.end();
+}
+
+eprosima::fastrtps::PublishModeQosPolicyKind
+get_publish_mode(
+  publishing_mode_t publishing_mode,
+  bool high_priority,
+  const TypeSupport * type_support)
+{
+  if (high_priority || publishing_mode == publishing_mode_t::SYNCHRONOUS) {
+    if (fits_unfragmented(type_support)) {
+      return eprosima::fastrtps::SYNCHRONOUS_PUBLISH_MODE;
+    }
+    // unbounded types may exceed a single RTPS message at any time, and would then fail to
+    // be written by a synchronous writer
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "type '%s' is unbounded or too big to be published synchronously, "
+      "%s writer falls back to the asynchronous writer thread",
+      type_support ? type_support->getName() : "unknown",
+      high_priority ? "high priority" : "synchronous");
+    return eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+  }
+
+  switch (publishing_mode) {
+    case publishing_mode_t::AUTO:
+      if (fits_unfragmented(type_support)) {
+        return eprosima::fastrtps::SYNCHRONOUS_PUBLISH_MODE;
+      }
+      return eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+    case publishing_mode_t::ASYNCHRONOUS:
+    default:
+      return eprosima::fastrtps::ASYNCHRONOUS_PUBLISH_MODE;
+  }
+}
+
+void
+set_resource_limits(
+  const CustomParticipantInfo * participant_info,
+  eprosima::fastrtps::TopicAttributes & topic)
+{
+  auto & limits = topic.resourceLimitsQos;
+  const int32_t depth = topic.historyQos.depth;
+
+  if (eprosima::fastrtps::KEEP_LAST_HISTORY_QOS == topic.historyQos.kind) {
+    // never truncate the requested history depth
+    if (depth > limits.max_samples) {
+      limits.max_samples = depth;
+    }
+    if (depth > limits.max_samples_per_instance) {
+      limits.max_samples_per_instance = depth;
+    }
+    return;
+  }
+
+  int32_t max_samples = limits.max_samples;
+  if (participant_info && participant_info->keep_all_max_samples > 0) {
+    max_samples = participant_info->keep_all_max_samples;
+  } else if (depth > 0) {
+    max_samples = depth;
+  }
+  int32_t allocated_samples = limits.allocated_samples;
+  if (participant_info && participant_info->keep_all_allocated_samples > 0) {
+    allocated_samples = participant_info->keep_all_allocated_samples;
+  }
+  if (max_samples > 0) {
+    if (allocated_samples > max_samples) {
+      allocated_samples = max_samples;
+    }
+    limits.max_samples = max_samples;
+    // topics have no key, so all the samples belong to a single instance
+    limits.max_samples_per_instance = max_samples;
+  }
+  limits.allocated_samples = allocated_samples;
+}
+
+int32_t
+get_history_samples(const eprosima::fastrtps::TopicAttributes & topic)
+{
+  const auto & limits = topic.resourceLimitsQos;
+  if (eprosima::fastrtps::KEEP_LAST_HISTORY_QOS != topic.historyQos.kind) {
+    return limits.max_samples > 0 ? limits.max_samples : 0;
+  }
+  int32_t samples = topic.historyQos.depth;
+  if (samples > limits.max_samples && limits.max_samples > 0) {
+    samples = limits.max_samples;
+  }
+  return samples > 0 ? samples : 0;
+}
+
+void
+set_history_memory_policy(
+  const CustomParticipantInfo * participant_info,
+  const TypeSupport * type_support,
+  eprosima::fastrtps::TopicAttributes & topic,
+  eprosima::fastrtps::rtps::MemoryManagementPolicy_t & memory_policy)
+{
+  const bool keep_last = eprosima::fastrtps::KEEP_LAST_HISTORY_QOS == topic.historyQos.kind;
+  const int32_t samples = get_history_samples(topic);
+
+  if (!type_support) {
+    memory_policy = eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    return;
+  }
+
+  if (participant_info && participant_info->zero_allocation && samples > 0) {
+    // the whole history is allocated once, whatever its size, and payloads of unbounded
+    // types only grow until they fit the largest sample
+    memory_policy = type_support->is_bounded() ?
+      eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE :
+      eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    topic.resourceLimitsQos.allocated_samples = samples;
+    return;
+  }
+
+  if (type_support->is_bounded()) {
+    if (
+      keep_last && samples > 0 &&
+      static_cast<uint64_t>(samples) * type_support->m_typeSize <= max_preallocated_history_size)
+    {
+      // every sample fits in m_typeSize, so the whole history is allocated once
+      memory_policy = eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE;
+      topic.resourceLimitsQos.allocated_samples = samples;
+    } else {
+      memory_policy = eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE;
+    }
+    return;
+  }
+
+  if (keep_last && samples > 0 && samples <= max_reallocated_history_samples) {
+    memory_policy = eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+    if (topic.resourceLimitsQos.allocated_samples > samples) {
+      topic.resourceLimitsQos.allocated_samples = samples;
+    }
+  } else {
+    memory_policy = eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE;
+  }
+}
+
+size_t
+get_preallocated_history_size(
+  const TypeSupport * type_support,
+  const eprosima::fastrtps::TopicAttributes & topic,
+  eprosima::fastrtps::rtps::MemoryManagementPolicy_t memory_policy)
+{
+  if (
+    !type_support || topic.resourceLimitsQos.allocated_samples <= 0 ||
+    eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE == memory_policy)
+  {
+    return 0;
+  }
+  return static_cast<size_t>(topic.resourceLimitsQos.allocated_samples) *
+         type_support->m_typeSize;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
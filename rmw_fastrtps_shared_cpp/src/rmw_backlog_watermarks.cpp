@@ -0,0 +1,125 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/backlog_watermarks.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "types/guard_condition.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+static std::function<void()>
+_guard_condition_trigger(const rmw_guard_condition_t * guard_condition)
+{
+  if (!guard_condition) {
+    return nullptr;
+  }
+  auto condition = static_cast<GuardCondition *>(guard_condition->data);
+  return [condition]() {condition->trigger();};
+}
+
+static rmw_ret_t
+_set_backlog_watermarks(
+  const char * identifier,
+  BacklogWatermarks & watermarks,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition)
+{
+  if (high_watermark > 0 && low_watermark >= high_watermark) {
+    RMW_SET_ERROR_MSG("low watermark must be lower than the high watermark");
+    return RMW_RET_ERROR;
+  }
+
+  if (
+    (high_guard_condition && high_guard_condition->implementation_identifier != identifier) ||
+    (low_guard_condition && low_guard_condition->implementation_identifier != identifier))
+  {
+    RMW_SET_ERROR_MSG("guard condition handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  watermarks.set(
+    high_watermark, low_watermark,
+    _guard_condition_trigger(high_guard_condition), _guard_condition_trigger(low_guard_condition));
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_set_subscription_backlog_watermarks(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  return _set_backlog_watermarks(
+    identifier, info->backlog_watermarks_, high_watermark, low_watermark,
+    high_guard_condition, low_guard_condition);
+}
+
+rmw_ret_t
+__rmw_set_service_backlog_watermarks(
+  const char * identifier,
+  const rmw_service_t * service,
+  size_t high_watermark,
+  size_t low_watermark,
+  const rmw_guard_condition_t * high_guard_condition,
+  const rmw_guard_condition_t * low_guard_condition)
+{
+  if (!service) {
+    RMW_SET_ERROR_MSG("service is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (service->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("service handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomServiceInfo *>(service->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("service info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  return _set_backlog_watermarks(
+    identifier, info->backlog_watermarks_, high_watermark, low_watermark,
+    high_guard_condition, low_guard_condition);
+}
+}  // namespace rmw_fastrtps_shared_cpp
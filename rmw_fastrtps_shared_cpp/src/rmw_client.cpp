@@ -38,7 +38,6 @@ __rmw_destroy_client(
   rmw_node_t * node,
   rmw_client_t * client)
 {
-  (void)node;
   if (!client) {
     RMW_SET_ERROR_MSG("client handle is null");
     return RMW_RET_ERROR;
@@ -68,6 +67,11 @@ __rmw_destroy_client(
     if (info->response_type_support_ != nullptr) {
       _unregister_type(info->participant_, info->response_type_support_);
     }
+    auto impl = static_cast<CustomParticipantInfo *>(node != nullptr ? node->data : nullptr);
+    if (impl != nullptr) {
+      impl->entity_counters.remove(&info->counters_);
+      unexport_statistics(node, info);
+    }
     delete info;
   }
   if (client->service_name != nullptr) {
@@ -0,0 +1,370 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/types.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/memory_footprint.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+static size_t
+_name_size(const char * name)
+{
+  return name ? strlen(name) + 1 : 0;
+}
+
+// Ordered set of strings, or ordered map from strings to values of type T
+static size_t
+_string_tree_size(const std::set<std::string> & strings)
+{
+  size_t bytes = 0;
+  for (const auto & string : strings) {
+    bytes += sizeof(string) + tree_node_overhead + string_heap_size(string);
+  }
+  return bytes;
+}
+
+template<typename T>
+static size_t
+_string_tree_size(const std::map<std::string, T> & strings)
+{
+  size_t bytes = 0;
+  for (const auto & string : strings) {
+    bytes += sizeof(string) + tree_node_overhead + string_heap_size(string.first);
+  }
+  return bytes;
+}
+
+// Topics of a topic cache with their types, also adding up the topic and type pairs if asked
+static size_t
+_topic_types_size(
+  const std::unordered_map<std::string, std::vector<std::string>> & topics,
+  uint64_t * topic_count = nullptr)
+{
+  size_t bytes = topics.bucket_count() * sizeof(void *);
+  for (const auto & topic : topics) {
+    bytes += sizeof(topic) + hash_node_overhead + string_heap_size(topic.first) +
+      topic.second.capacity() * sizeof(std::string);
+    for (const auto & type : topic.second) {
+      bytes += string_heap_size(type);
+    }
+    if (topic_count) {
+      *topic_count += topic.second.size();
+    }
+  }
+  return bytes;
+}
+
+// Must be called with the mutex of the topic cache held
+static void
+_add_peer_topics(
+  const TopicCache & topic_cache,
+  std::map<GUID_t, PeerMemoryFootprint> & peers)
+{
+  for (const auto & participant : topic_cache.getParticipantToTopics()) {
+    PeerMemoryFootprint & peer = peers[participant.first];
+    peer.bytes += sizeof(participant) + tree_node_overhead +
+      _topic_types_size(participant.second, &peer.topic_count);
+  }
+}
+
+// Names, namespaces and topics of the participants discovered by a node
+static std::map<GUID_t, PeerMemoryFootprint>
+_get_peer_memory_footprints(::ParticipantListener * listener)
+{
+  std::map<GUID_t, PeerMemoryFootprint> peers;
+  for (const auto & name : listener->discovered_names) {
+    peers[name.first].bytes +=
+      sizeof(name) + tree_node_overhead + string_heap_size(name.second);
+  }
+  for (const auto & namespace_ : listener->discovered_namespaces) {
+    peers[namespace_.first].bytes +=
+      sizeof(namespace_) + tree_node_overhead + string_heap_size(namespace_.second);
+  }
+  {
+    std::lock_guard<std::mutex> guard(listener->reader_topic_cache.getMutex());
+    _add_peer_topics(listener->reader_topic_cache, peers);
+  }
+  {
+    std::lock_guard<std::mutex> guard(listener->writer_topic_cache.getMutex());
+    _add_peer_topics(listener->writer_topic_cache, peers);
+  }
+  for (auto & peer : peers) {
+    memcpy(peer.second.guid, &peer.first, sizeof(peer.second.guid));
+  }
+  return peers;
+}
+
+rmw_ret_t
+__rmw_get_publisher_memory_footprint(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  MemoryFootprint * footprint)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (publisher->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprint) {
+    RMW_SET_ERROR_MSG("footprint is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  if (!info || !info->listener_) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *footprint = MemoryFootprint();
+  footprint->entity_bytes =
+    sizeof(rmw_publisher_t) + _name_size(publisher->topic_name) +
+    sizeof(CustomPublisherInfo) + sizeof(TypeSupport) +
+    sizeof(PubListener) + info->listener_->memoryFootprint();
+  footprint->history_bytes = info->preallocated_history_size_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_memory_footprint(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  MemoryFootprint * footprint)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprint) {
+    RMW_SET_ERROR_MSG("footprint is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (!info || !info->listener_) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *footprint = MemoryFootprint();
+  footprint->entity_bytes =
+    sizeof(rmw_subscription_t) + _name_size(subscription->topic_name) +
+    sizeof(CustomSubscriberInfo) + sizeof(TypeSupport) + info->sample_loss_.memory_footprint() +
+    sizeof(SubListener) + info->listener_->memoryFootprint();
+  if (info->mailbox_) {
+    std::lock_guard<std::mutex> lock(info->mailbox_->mutex_);
+    footprint->entity_bytes += sizeof(SubscriberMailbox) + info->mailbox_->buffer_.getBufferSize();
+  }
+  if (info->take_buffer_) {
+    footprint->entity_bytes +=
+      sizeof(eprosima::fastcdr::FastBuffer) + info->take_buffer_->getBufferSize();
+  }
+  footprint->history_bytes = info->preallocated_history_size_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_service_memory_footprint(
+  const char * identifier,
+  const rmw_service_t * service,
+  MemoryFootprint * footprint)
+{
+  if (!service) {
+    RMW_SET_ERROR_MSG("service is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (service->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("service handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprint) {
+    RMW_SET_ERROR_MSG("footprint is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomServiceInfo *>(service->data);
+  if (!info || !info->listener_) {
+    RMW_SET_ERROR_MSG("service info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *footprint = MemoryFootprint();
+  footprint->entity_bytes =
+    sizeof(rmw_service_t) + _name_size(service->service_name) +
+    sizeof(CustomServiceInfo) + 2 * sizeof(TypeSupport) +
+    sizeof(ServiceListener) + info->listener_->memoryFootprint();
+  footprint->history_bytes = info->preallocated_history_size_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_client_memory_footprint(
+  const char * identifier,
+  const rmw_client_t * client,
+  MemoryFootprint * footprint)
+{
+  if (!client) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (client->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprint) {
+    RMW_SET_ERROR_MSG("footprint is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomClientInfo *>(client->data);
+  if (!info || !info->listener_) {
+    RMW_SET_ERROR_MSG("client info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *footprint = MemoryFootprint();
+  footprint->entity_bytes =
+    sizeof(rmw_client_t) + _name_size(client->service_name) +
+    sizeof(CustomClientInfo) + 2 * sizeof(TypeSupport) +
+    sizeof(ClientListener) + info->listener_->memoryFootprint() + sizeof(ClientPubListener);
+  footprint->history_bytes = info->preallocated_history_size_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_node_memory_footprint(
+  const char * identifier,
+  const rmw_node_t * node,
+  MemoryFootprint * footprint)
+{
+  if (!node) {
+    RMW_SET_ERROR_MSG("node is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (node->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("node handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprint) {
+    RMW_SET_ERROR_MSG("footprint is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomParticipantInfo *>(node->data);
+  if (!info || !info->listener) {
+    RMW_SET_ERROR_MSG("node info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *footprint = MemoryFootprint();
+  footprint->entity_bytes =
+    sizeof(rmw_node_t) + _name_size(node->name) + _name_size(node->namespace_) +
+    sizeof(CustomParticipantInfo) + sizeof(::ParticipantListener) +
+    _string_tree_size(info->high_priority_topics) + _string_tree_size(info->mailbox_topics) +
+    _string_tree_size(info->minimum_separations) + _string_tree_size(info->max_sample_ages);
+
+  ::ParticipantListener * listener = info->listener;
+  for (const auto & peer : _get_peer_memory_footprints(listener)) {
+    footprint->discovery_bytes += peer.second.bytes;
+  }
+  // the topics of the node are those of every participant, merged
+  {
+    std::lock_guard<std::mutex> guard(listener->reader_topic_cache.getMutex());
+    footprint->discovery_bytes +=
+      _topic_types_size(listener->reader_topic_cache.getTopicToTypes());
+  }
+  {
+    std::lock_guard<std::mutex> guard(listener->writer_topic_cache.getMutex());
+    footprint->discovery_bytes +=
+      _topic_types_size(listener->writer_topic_cache.getTopicToTypes());
+  }
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_node_peer_memory_footprints(
+  const char * identifier,
+  const rmw_node_t * node,
+  PeerMemoryFootprint * footprints,
+  size_t capacity,
+  size_t * count)
+{
+  if (!node) {
+    RMW_SET_ERROR_MSG("node is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (node->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("node handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!footprints && capacity > 0) {
+    RMW_SET_ERROR_MSG("footprints is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (!count) {
+    RMW_SET_ERROR_MSG("count is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomParticipantInfo *>(node->data);
+  if (!info || !info->listener) {
+    RMW_SET_ERROR_MSG("node info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto peers = _get_peer_memory_footprints(info->listener);
+  size_t i = 0;
+  for (auto it = peers.begin(); it != peers.end() && i < capacity; ++it) {
+    footprints[i++] = it->second;
+  }
+  *count = peers.size();
+  return RMW_RET_OK;
+}
+}  // namespace rmw_fastrtps_shared_cpp
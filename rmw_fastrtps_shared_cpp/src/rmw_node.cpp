@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <array>
+#include <cstdio>
+#include <limits>
+#include <map>
 #include <utility>
 #include <set>
 #include <string>
@@ -45,6 +48,8 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/statistics_export.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
 
 using Domain = eprosima::fastrtps::Domain;
 using Participant = eprosima::fastrtps::Participant;
@@ -53,6 +58,195 @@ using StatefulReader = eprosima::fastrtps::rtps::StatefulReader;
 
 namespace rmw_fastrtps_shared_cpp
 {
+// Records of the statistics file, enough for the nodes and entities of most processes
+static constexpr size_t statistics_export_record_capacity = 1024;
+
+// Parsers of the env variables configuring the participant, private to this file
+namespace
+{
+
+/// Return the value of the given env variable, or an empty string if it is not set.
+std::string
+get_env_value(const char * env_var)
+{
+  std::string value;
+  char * config_env_val = nullptr;
+#ifndef _WIN32
+  config_env_val = getenv(env_var);
+  if (config_env_val != nullptr) {
+    value = config_env_val;
+  }
+#else
+  size_t config_env_val_size;
+  _dupenv_s(&config_env_val, &config_env_val_size, env_var);
+  if (config_env_val != nullptr) {
+    value = config_env_val;
+  }
+  free(config_env_val);
+#endif
+  return value;
+}
+
+/// Parse the value of the RMW_FASTRTPS_PUBLICATION_MODE env variable.
+publishing_mode_t
+get_publishing_mode(const std::string & env_value)
+{
+  if (env_value.empty() || env_value == "ASYNCHRONOUS") {
+    return publishing_mode_t::ASYNCHRONOUS;
+  }
+  if (env_value == "SYNCHRONOUS") {
+    return publishing_mode_t::SYNCHRONOUS;
+  }
+  if (env_value == "AUTO") {
+    return publishing_mode_t::AUTO;
+  }
+  RCUTILS_LOG_WARN_NAMED(
+    "rmw_fastrtps_shared_cpp",
+    "unknown RMW_FASTRTPS_PUBLICATION_MODE '%s', using ASYNCHRONOUS", env_value.c_str());
+  return publishing_mode_t::ASYNCHRONOUS;
+}
+
+/// Parse a comma separated list of names, ignoring surrounding whitespace and empty entries.
+std::set<std::string>
+get_name_set(const std::string & env_value)
+{
+  std::set<std::string> names;
+  size_t begin = 0;
+  while (begin <= env_value.size()) {
+    size_t end = env_value.find(',', begin);
+    if (end == std::string::npos) {
+      end = env_value.size();
+    }
+    size_t first = env_value.find_first_not_of(" \t", begin);
+    if (first != std::string::npos && first < end) {
+      size_t last = env_value.find_last_not_of(" \t", end - 1);
+      names.insert(env_value.substr(first, last - first + 1));
+    }
+    begin = end + 1;
+  }
+  return names;
+}
+
+/// Parse a comma separated list of "<name>=<value>" entries, ignoring surrounding whitespace.
+std::map<std::string, std::string>
+get_name_value_map(const char * env_var, const std::string & env_value)
+{
+  std::map<std::string, std::string> values;
+  for (const auto & entry : get_name_set(env_value)) {
+    size_t separator = entry.rfind('=');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == entry.size()) {
+      RCUTILS_LOG_WARN_NAMED(
+        "rmw_fastrtps_shared_cpp",
+        "ignoring malformed %s entry '%s', expected '<name>=<value>'",
+        env_var, entry.c_str());
+      continue;
+    }
+    size_t name_end = entry.find_last_not_of(" \t", separator - 1);
+    size_t value_begin = entry.find_first_not_of(" \t", separator + 1);
+    if (name_end == std::string::npos || value_begin == std::string::npos) {
+      RCUTILS_LOG_WARN_NAMED(
+        "rmw_fastrtps_shared_cpp",
+        "ignoring malformed %s entry '%s', expected '<name>=<value>'",
+        env_var, entry.c_str());
+      continue;
+    }
+    values[entry.substr(0, name_end + 1)] = entry.substr(value_begin);
+  }
+  return values;
+}
+
+/// Parse a throughput limit given as "<bytes_per_period>/<period_ms>".
+/**
+ * Leave the descriptor untouched, meaning no limit, if the value is empty or malformed.
+ */
+void
+get_throughput_controller(
+  const char * env_var,
+  const std::string & env_value,
+  eprosima::fastrtps::rtps::ThroughputControllerDescriptor & descriptor)
+{
+  if (env_value.empty()) {
+    return;
+  }
+  unsigned long bytes_per_period = 0;  // NOLINT(runtime/int)
+  unsigned long period_ms = 0;  // NOLINT(runtime/int)
+  char trailing = '\0';
+  if (
+    sscanf(env_value.c_str(), "%lu/%lu%c", &bytes_per_period, &period_ms, &trailing) != 2 ||
+    bytes_per_period == 0 || bytes_per_period > (std::numeric_limits<uint32_t>::max)() ||
+    period_ms == 0 || period_ms > (std::numeric_limits<uint32_t>::max)())
+  {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "ignoring malformed %s '%s', expected '<bytes_per_period>/<period_ms>'",
+      env_var, env_value.c_str());
+    return;
+  }
+  descriptor.bytesPerPeriod = static_cast<uint32_t>(bytes_per_period);
+  descriptor.periodMillisecs = static_cast<uint32_t>(period_ms);
+}
+
+/// Parse a duration given in milliseconds.
+/**
+ * Leave the duration untouched, meaning the middleware default is kept,
+ * if the value is empty or malformed.
+ */
+void
+get_duration(
+  const char * env_var,
+  const std::string & env_value,
+  eprosima::fastrtps::rtps::Duration_t & duration)
+{
+  if (env_value.empty()) {
+    return;
+  }
+  unsigned long milliseconds = 0;  // NOLINT(runtime/int)
+  char trailing = '\0';
+  if (
+    sscanf(env_value.c_str(), "%lu%c", &milliseconds, &trailing) != 1 ||
+    milliseconds / 1000 > static_cast<unsigned long>(  // NOLINT(runtime/int)
+      (std::numeric_limits<int32_t>::max)()))
+  {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "ignoring malformed %s '%s', expected a number of milliseconds",
+      env_var, env_value.c_str());
+    return;
+  }
+  duration.seconds = static_cast<int32_t>(milliseconds / 1000);
+  // the fraction is expressed in units of 1/2^32 seconds
+  duration.fraction = static_cast<uint32_t>(
+    ((static_cast<uint64_t>(milliseconds % 1000) << 32) + 500) / 1000);
+}
+
+/// Parse a positive number of samples.
+/**
+ * Leave the count untouched if the value is empty or malformed.
+ */
+void
+get_sample_count(const char * env_var, const std::string & env_value, int32_t & count)
+{
+  if (env_value.empty()) {
+    return;
+  }
+  unsigned long samples = 0;  // NOLINT(runtime/int)
+  char trailing = '\0';
+  if (
+    sscanf(env_value.c_str(), "%lu%c", &samples, &trailing) != 1 ||
+    samples == 0 || samples > static_cast<unsigned long>(  // NOLINT(runtime/int)
+      (std::numeric_limits<int32_t>::max)()))
+  {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "ignoring malformed %s '%s', expected a positive number of samples",
+      env_var, env_value.c_str());
+    return;
+  }
+  count = static_cast<int32_t>(samples);
+}
+
+}  // namespace
+
 rmw_node_t *
 create_node(
   const char * identifier,
@@ -99,24 +293,98 @@ create_node(
   try {
     node_impl = new CustomParticipantInfo();
 
-    node_impl->leave_middleware_default_qos = false;
-    const char * env_var = "RMW_FASTRTPS_USE_QOS_FROM_XML";
     // Check if the configuration from XML has been enabled from
     // the RMW_FASTRTPS_USE_QOS_FROM_XML env variable.
-    char * config_env_val = nullptr;
-#ifndef _WIN32
-    config_env_val = getenv(env_var);
-    if (config_env_val != nullptr) {
-      node_impl->leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
+    node_impl->leave_middleware_default_qos =
+      get_env_value("RMW_FASTRTPS_USE_QOS_FROM_XML") == "1";
+    node_impl->publishing_mode =
+      get_publishing_mode(get_env_value("RMW_FASTRTPS_PUBLICATION_MODE"));
+    get_throughput_controller(
+      "RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT",
+      get_env_value("RMW_FASTRTPS_PUBLISHER_THROUGHPUT_LIMIT"),
+      node_impl->publisher_throughput_controller);
+    node_impl->high_priority_topics =
+      get_name_set(get_env_value("RMW_FASTRTPS_HIGH_PRIORITY_TOPICS"));
+
+    eprosima::fastrtps::PublisherAttributes publisherAttrs;
+    eprosima::fastrtps::SubscriberAttributes subscriberAttrs;
+    Domain::getDefaultPublisherAttributes(publisherAttrs);
+    Domain::getDefaultSubscriberAttributes(subscriberAttrs);
+    node_impl->writer_times = publisherAttrs.times;
+    node_impl->reader_times = subscriberAttrs.times;
+    get_duration(
+      "RMW_FASTRTPS_HEARTBEAT_PERIOD_MS",
+      get_env_value("RMW_FASTRTPS_HEARTBEAT_PERIOD_MS"),
+      node_impl->writer_times.heartbeatPeriod);
+    get_duration(
+      "RMW_FASTRTPS_INITIAL_HEARTBEAT_DELAY_MS",
+      get_env_value("RMW_FASTRTPS_INITIAL_HEARTBEAT_DELAY_MS"),
+      node_impl->writer_times.initialHeartbeatDelay);
+    get_duration(
+      "RMW_FASTRTPS_NACK_RESPONSE_DELAY_MS",
+      get_env_value("RMW_FASTRTPS_NACK_RESPONSE_DELAY_MS"),
+      node_impl->writer_times.nackResponseDelay);
+    get_duration(
+      "RMW_FASTRTPS_HEARTBEAT_RESPONSE_DELAY_MS",
+      get_env_value("RMW_FASTRTPS_HEARTBEAT_RESPONSE_DELAY_MS"),
+      node_impl->reader_times.heartbeatResponseDelay);
+    get_duration(
+      "RMW_FASTRTPS_INITIAL_ACKNACK_DELAY_MS",
+      get_env_value("RMW_FASTRTPS_INITIAL_ACKNACK_DELAY_MS"),
+      node_impl->reader_times.initialAcknackDelay);
+
+    for (const auto & separation : get_name_value_map(
+        "RMW_FASTRTPS_MINIMUM_SEPARATION_MS",
+        get_env_value("RMW_FASTRTPS_MINIMUM_SEPARATION_MS")))
+    {
+      // a negative duration is left when the value is malformed
+      eprosima::fastrtps::rtps::Duration_t duration;
+      duration.seconds = -1;
+      get_duration("RMW_FASTRTPS_MINIMUM_SEPARATION_MS", separation.second, duration);
+      if (duration.seconds >= 0) {
+        node_impl->minimum_separations[separation.first] = duration;
+      }
     }
-#else
-    size_t config_env_val_size;
-    _dupenv_s(&config_env_val, &config_env_val_size, env_var);
-    if (config_env_val != nullptr) {
-      node_impl->leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
+    for (const auto & age : get_name_value_map(
+        "RMW_FASTRTPS_MAX_SAMPLE_AGE_MS",
+        get_env_value("RMW_FASTRTPS_MAX_SAMPLE_AGE_MS")))
+    {
+      eprosima::fastrtps::rtps::Duration_t duration;
+      duration.seconds = -1;
+      get_duration("RMW_FASTRTPS_MAX_SAMPLE_AGE_MS", age.second, duration);
+      if (duration.seconds >= 0) {
+        node_impl->max_sample_ages[age.first] = duration;
+      }
     }
-    free(config_env_val);
-#endif
+    node_impl->mailbox_topics =
+      get_name_set(get_env_value("RMW_FASTRTPS_MAILBOX_TOPICS"));
+    node_impl->zero_allocation = get_env_value("RMW_FASTRTPS_ZERO_ALLOCATION") == "1";
+    node_impl->entity_counters.set_conversion_timing(
+      get_env_value("RMW_FASTRTPS_CONVERSION_TIMING") == "1");
+
+    std::string export_directory = get_env_value("RMW_FASTRTPS_STATISTICS_EXPORT_DIR");
+    if (!export_directory.empty()) {
+      eprosima::fastrtps::rtps::Duration_t export_period(1, 0);
+      get_duration(
+        "RMW_FASTRTPS_STATISTICS_EXPORT_PERIOD_MS",
+        get_env_value("RMW_FASTRTPS_STATISTICS_EXPORT_PERIOD_MS"),
+        export_period);
+      int64_t export_period_ns = time_to_nanoseconds(export_period);
+      node_impl->statistics_exporter = StatisticsExporter::get_instance(
+        export_directory, export_period_ns > 0 ? export_period_ns : 1000000000LL,
+        statistics_export_record_capacity);
+    }
+
+    node_impl->keep_all_max_samples = 0;
+    node_impl->keep_all_allocated_samples = 0;
+    get_sample_count(
+      "RMW_FASTRTPS_KEEP_ALL_MAX_SAMPLES",
+      get_env_value("RMW_FASTRTPS_KEEP_ALL_MAX_SAMPLES"),
+      node_impl->keep_all_max_samples);
+    get_sample_count(
+      "RMW_FASTRTPS_KEEP_ALL_ALLOCATED_SAMPLES",
+      get_env_value("RMW_FASTRTPS_KEEP_ALL_ALLOCATED_SAMPLES"),
+      node_impl->keep_all_allocated_samples);
   } catch (std::bad_alloc &) {
     RMW_SET_ERROR_MSG("failed to allocate node impl struct");
     goto fail;
@@ -150,6 +418,7 @@ create_node(
   }
   memcpy(const_cast<char *>(node_handle->namespace_), namespace_, strlen(namespace_) + 1);
 
+  export_node_statistics(node_handle);
   return node_handle;
 fail:
   if (node_handle) {
@@ -235,24 +504,9 @@ __rmw_create_node(
   // since the participant name is not part of the DDS spec
   participantAttrs.rtps.setName(name);
 
-  bool leave_middleware_default_qos = false;
-  const char * env_var = "RMW_FASTRTPS_USE_QOS_FROM_XML";
   // Check if the configuration from XML has been enabled from
   // the RMW_FASTRTPS_USE_QOS_FROM_XML env variable.
-  char * config_env_val = nullptr;
-#ifndef _WIN32
-  config_env_val = getenv(env_var);
-  if (config_env_val != nullptr) {
-    leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
-  }
-#else
-  size_t config_env_val_size;
-  _dupenv_s(&config_env_val, &config_env_val_size, env_var);
-  if (config_env_val != nullptr) {
-    leave_middleware_default_qos = strcmp(config_env_val, "1") == 0;
-  }
-  free(config_env_val);
-#endif
+  bool leave_middleware_default_qos = get_env_value("RMW_FASTRTPS_USE_QOS_FROM_XML") == "1";
 
   // allow reallocation to support discovery messages bigger than 5000 bytes
   if (!leave_middleware_default_qos) {
@@ -260,6 +514,12 @@ __rmw_create_node(
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
     participantAttrs.rtps.builtin.writerHistoryMemoryPolicy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+
+    // aggregate bandwidth limit shared by all the asynchronous writers of the participant
+    get_throughput_controller(
+      "RMW_FASTRTPS_PARTICIPANT_THROUGHPUT_LIMIT",
+      get_env_value("RMW_FASTRTPS_PARTICIPANT_THROUGHPUT_LIMIT"),
+      participantAttrs.rtps.throughputController);
   }
 
   size_t length = strlen(name) + strlen("name=;") +
@@ -342,6 +602,8 @@ __rmw_destroy_node(
 
   Participant * participant = impl->participant;
 
+  unexport_statistics(node, impl);
+
   // Begin deleting things in the same order they were created in __rmw_create_node().
   rmw_free(const_cast<char *>(node->name));
   node->name = nullptr;
@@ -21,10 +21,36 @@
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
 {
+static rmw_ret_t
+_publish_failed(CustomPublisherInfo * info, const SerializedData & data)
+{
+  // the sample is serialized first, the length is only set once it succeeded
+  if (data.cdr_length == 0) {
+    RMW_SET_ERROR_MSG("cannot publish data, serialization failed");
+    return RMW_RET_ERROR;
+  }
+  // KEEP_ALL writers fail once their history is full of unacknowledged samples, while a
+  // history with every sample acknowledged would have made room for a new one.
+  // Fast RTPS does not expose the size of the history, so the acknowledgements are checked.
+  const auto & topic = info->publisher_->getAttributes().topic;
+  if (
+    eprosima::fastrtps::KEEP_ALL_HISTORY_QOS == topic.historyQos.kind &&
+    !info->publisher_->wait_for_all_acked(eprosima::fastrtps::rtps::Duration_t(0, 0)))
+  {
+    ++info->history_overflow_count_;
+    RMW_SET_ERROR_MSG("cannot publish data, publisher history is full");
+    return RMW_RET_ERROR;
+  }
+  RMW_SET_ERROR_MSG("cannot publish data");
+  return RMW_RET_ERROR;
+}
+
 rmw_ret_t
 __rmw_publish(
   const char * identifier,
@@ -43,13 +69,24 @@ __rmw_publish(
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
 
+  RMW_FASTRTPS_TRACEPOINT(publish_entry, info->publisher_gid.data, ros_message);
+
+  eprosima::fastrtps::rtps::WriteParams wparams;
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = false;
+  data.cdr_length = 0;
   data.data = const_cast<void *>(ros_message);
-  if (!info->publisher_->write(&data)) {
-    RMW_SET_ERROR_MSG("cannot publish data");
-    return RMW_RET_ERROR;
+  data.time_conversion = info->counters_.times_conversions();
+  if (!info->publisher_->write(&data, wparams)) {
+    RMW_FASTRTPS_TRACEPOINT(publish_exit, info->publisher_gid.data, -1);
+    return _publish_failed(info, data);
   }
+  info->counters_.message_sent(data.cdr_length, data.conversion_time_ns);
+  info->rate_.record(current_time_nanoseconds(), data.cdr_length);
+
+  RMW_FASTRTPS_TRACEPOINT(
+    publish_exit, info->publisher_gid.data,
+    sequence_number_to_int64(wparams.sample_identity().sequence_number()));
 
   return RMW_RET_OK;
 }
@@ -81,13 +118,23 @@ __rmw_publish_serialized_message(
     return RMW_RET_ERROR;
   }
 
+  RMW_FASTRTPS_TRACEPOINT(publish_entry, info->publisher_gid.data, serialized_message);
+
+  eprosima::fastrtps::rtps::WriteParams wparams;
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = true;
+  data.cdr_length = 0;
   data.data = &ser;
-  if (!info->publisher_->write(&data)) {
-    RMW_SET_ERROR_MSG("cannot publish data");
-    return RMW_RET_ERROR;
+  if (!info->publisher_->write(&data, wparams)) {
+    RMW_FASTRTPS_TRACEPOINT(publish_exit, info->publisher_gid.data, -1);
+    return _publish_failed(info, data);
   }
+  info->counters_.message_sent(data.cdr_length, data.conversion_time_ns);
+  info->rate_.record(current_time_nanoseconds(), data.cdr_length);
+
+  RMW_FASTRTPS_TRACEPOINT(
+    publish_exit, info->publisher_gid.data,
+    sequence_number_to_int64(wparams.sample_identity().sequence_number()));
 
   return RMW_RET_OK;
 }
@@ -77,6 +77,11 @@ __rmw_destroy_publisher(
       Participant * participant = impl->participant;
       _unregister_type(participant, info->type_support_);
     }
+    auto impl = static_cast<CustomParticipantInfo *>(node->data);
+    if (impl != nullptr) {
+      impl->entity_counters.remove(&info->counters_);
+      unexport_statistics(node, info);
+    }
     delete info;
   }
   rmw_free(const_cast<char *>(publisher->topic_name));
@@ -26,6 +26,8 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
@@ -55,10 +57,15 @@ __rmw_send_request(
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = false;
   data.data = const_cast<void *>(ros_request);
+  data.time_conversion = info->counters_.times_conversions();
+  int64_t sent_ns = current_time_nanoseconds();
   if (info->request_publisher_->write(&data, wparams)) {
+    info->counters_.message_sent(data.cdr_length, data.conversion_time_ns);
     returnedValue = RMW_RET_OK;
     *sequence_id = ((int64_t)wparams.sample_identity().sequence_number().high) << 32 |
       wparams.sample_identity().sequence_number().low;
+    RMW_FASTRTPS_TRACEPOINT(send_request, &info->writer_guid_, *sequence_id);
+    info->round_trip_.request_sent(*sequence_id, sent_ns);
   } else {
     RMW_SET_ERROR_MSG("cannot publish data");
   }
@@ -92,19 +99,29 @@ __rmw_take_request(
   CustomServiceRequest request = info->listener_->getRequest();
 
   if (request.buffer_ != nullptr) {
+    auto start = info->counters_.conversion_start();
     eprosima::fastcdr::Cdr deser(*request.buffer_, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
       eprosima::fastcdr::Cdr::DDS_CDR);
     info->request_type_support_->deserializeROSmessage(deser, ros_request);
+    info->counters_.message_taken(request.length_, info->counters_.conversion_time_ns(start));
 
     // Get header
     memcpy(request_header->writer_guid, &request.sample_identity_.writer_guid(),
       sizeof(eprosima::fastrtps::rtps::GUID_t));
     request_header->sequence_number = ((int64_t)request.sample_identity_.sequence_number().high) <<
       32 | request.sample_identity_.sequence_number().low;
+    RMW_FASTRTPS_TRACEPOINT(
+      take_request, &info->request_subscriber_->getGuid(),
+      &request.sample_identity_.writer_guid(), request_header->sequence_number);
+    info->last_taken_.source_timestamp_ns = request.source_timestamp_ns_;
+    info->last_taken_.reception_timestamp_ns = request.reception_timestamp_ns_;
+    info->last_taken_.sequence_number = request_header->sequence_number;
 
-    delete request.buffer_;
+    info->listener_->releaseBuffer(request.buffer_);
 
     *taken = true;
+  } else {
+    info->counters_.take_missed();
   }
 
   return RMW_RET_OK;
@@ -24,6 +24,7 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
@@ -54,16 +55,29 @@ __rmw_take_response(
   CustomClientResponse response;
 
   if (info->listener_->getResponse(response)) {
+    auto start = info->counters_.conversion_start();
     eprosima::fastcdr::Cdr deser(
       *response.buffer_,
       eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
       eprosima::fastcdr::Cdr::DDS_CDR);
     info->response_type_support_->deserializeROSmessage(deser, ros_response);
+    info->counters_.message_taken(response.length_, info->counters_.conversion_time_ns(start));
 
     request_header->sequence_number = ((int64_t)response.sample_identity_.sequence_number().high) <<
       32 | response.sample_identity_.sequence_number().low;
+    RMW_FASTRTPS_TRACEPOINT(
+      take_response, &info->response_subscriber_->getGuid(),
+      &response.sample_identity_.writer_guid(), request_header->sequence_number);
+    info->last_taken_.source_timestamp_ns = response.source_timestamp_ns_;
+    info->last_taken_.reception_timestamp_ns = response.reception_timestamp_ns_;
+    info->last_taken_.sequence_number = response.sequence_number_;
+    info->round_trip_.response_received(
+      request_header->sequence_number, response.reception_timestamp_ns_);
+    info->listener_->releaseBuffer(response.buffer_.release());
 
     *taken = true;
+  } else {
+    info->counters_.take_missed();
   }
 
   return RMW_RET_OK;
@@ -101,8 +115,13 @@ __rmw_send_response(
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = false;
   data.data = const_cast<void *>(ros_response);
+  data.time_conversion = info->counters_.times_conversions();
 
   if (info->response_publisher_->write(&data, wparams)) {
+    info->counters_.message_sent(data.cdr_length, data.conversion_time_ns);
+    RMW_FASTRTPS_TRACEPOINT(
+      send_response, &info->response_publisher_->getGuid(),
+      request_header->writer_guid, request_header->sequence_number);
     returnedValue = RMW_RET_OK;
   } else {
     RMW_SET_ERROR_MSG("cannot publish data");
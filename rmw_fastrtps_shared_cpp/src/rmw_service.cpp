@@ -49,7 +49,6 @@ __rmw_destroy_service(
   rmw_node_t * node,
   rmw_service_t * service)
 {
-  (void)node;
   if (!service) {
     RMW_SET_ERROR_MSG("service handle is null");
     return RMW_RET_ERROR;
@@ -77,6 +76,11 @@ __rmw_destroy_service(
     if (info->response_type_support_ != nullptr) {
       _unregister_type(info->participant_, info->response_type_support_);
     }
+    auto impl = static_cast<CustomParticipantInfo *>(node != nullptr ? node->data : nullptr);
+    if (impl != nullptr) {
+      impl->entity_counters.remove(&info->counters_);
+      unexport_statistics(node, info);
+    }
     delete info;
   }
   if (service->service_name != nullptr) {
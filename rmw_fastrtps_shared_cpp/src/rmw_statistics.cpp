@@ -0,0 +1,598 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/types.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "types/custom_wait_set_info.hpp"
+#include "types/guard_condition.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+rmw_ret_t
+__rmw_get_publisher_history_overflow_count(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  uint64_t * count)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (publisher->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!count) {
+    RMW_SET_ERROR_MSG("count is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomPublisherInfo *>(publisher->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *count = info->history_overflow_count_.load();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_history_overflow_count(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  uint64_t * count)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!count) {
+    RMW_SET_ERROR_MSG("count is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info || !info->listener_) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *count = info->listener_->historyBecameFullCount();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_expired_sample_count(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  uint64_t * count)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!count) {
+    RMW_SET_ERROR_MSG("count is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *count = info->expired_sample_count_.load();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_publisher_statistics(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  EntityStatistics * statistics)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (publisher->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomPublisherInfo *>(publisher->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *statistics = EntityStatistics();
+  info->counters_.add_to(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_statistics(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  EntityStatistics * statistics)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *statistics = EntityStatistics();
+  info->counters_.add_to(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_service_statistics(
+  const char * identifier,
+  const rmw_service_t * service,
+  EntityStatistics * statistics)
+{
+  if (!service) {
+    RMW_SET_ERROR_MSG("service is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (service->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("service handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomServiceInfo *>(service->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("service info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *statistics = EntityStatistics();
+  info->counters_.add_to(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_client_statistics(
+  const char * identifier,
+  const rmw_client_t * client,
+  EntityStatistics * statistics)
+{
+  if (!client) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (client->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomClientInfo *>(client->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("client info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *statistics = EntityStatistics();
+  info->counters_.add_to(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_node_statistics(
+  const char * identifier,
+  const rmw_node_t * node,
+  EntityStatistics * statistics)
+{
+  if (!node) {
+    RMW_SET_ERROR_MSG("node is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (node->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("node handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomParticipantInfo *>(node->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("node info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *statistics = EntityStatistics();
+  info->entity_counters.add_to(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_node_discovery_statistics(
+  const char * identifier,
+  const rmw_node_t * node,
+  DiscoveryStatistics * statistics)
+{
+  if (!node) {
+    RMW_SET_ERROR_MSG("node is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (node->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("node handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomParticipantInfo *>(node->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("node info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->listener->discovery_counters_.snapshot(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_wait_set_statistics(
+  const char * identifier,
+  const rmw_wait_set_t * wait_set,
+  WaitSetStatistics * statistics,
+  LatencyHistogram * overhead)
+{
+  if (!wait_set) {
+    RMW_SET_ERROR_MSG("wait set is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (wait_set->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("wait set handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomWaitsetInfo *>(wait_set->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("wait set info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->counters.snapshot(*statistics, overhead);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_latency_histograms(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  LatencyHistogram * transport_latency,
+  LatencyHistogram * queueing_latency)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!transport_latency || !queueing_latency) {
+    RMW_SET_ERROR_MSG("latency histogram is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->transport_latency_.snapshot(*transport_latency);
+  info->queueing_latency_.snapshot(*queueing_latency);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_reset_subscription_latency_histograms(
+  const char * identifier,
+  const rmw_subscription_t * subscription)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->transport_latency_.reset();
+  info->queueing_latency_.reset();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_client_round_trip_latency(
+  const char * identifier,
+  const rmw_client_t * client,
+  LatencyHistogram * round_trip_latency)
+{
+  if (!client) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (client->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!round_trip_latency) {
+    RMW_SET_ERROR_MSG("round_trip_latency is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomClientInfo *>(client->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("client info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->round_trip_.snapshot(*round_trip_latency);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_reset_client_round_trip_latency(
+  const char * identifier,
+  const rmw_client_t * client)
+{
+  if (!client) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (client->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomClientInfo *>(client->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("client info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->round_trip_.reset();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_publisher_rate_statistics(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  RateStatistics * statistics)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (publisher->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("publisher handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomPublisherInfo *>(publisher->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->rate_.snapshot(*statistics, current_time_nanoseconds());
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_rate_statistics(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  RateStatistics * statistics)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->rate_.snapshot(*statistics, current_time_nanoseconds());
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_subscription_sample_loss(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  SampleLossStatistics * statistics)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!statistics) {
+    RMW_SET_ERROR_MSG("statistics is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  info->sample_loss_.snapshot(*statistics);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_set_subscription_sample_loss_alarm(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  double loss_ratio,
+  size_t window,
+  const rmw_guard_condition_t * guard_condition)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (!guard_condition) {
+    info->sample_loss_.set_alarm(0.0, 0, nullptr);
+    return RMW_RET_OK;
+  }
+
+  if (guard_condition->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("guard condition handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!(loss_ratio > 0.0 && loss_ratio <= 1.0) || window == 0) {
+    RMW_SET_ERROR_MSG("loss ratio must be in (0, 1] and window must be positive");
+    return RMW_RET_ERROR;
+  }
+
+  auto condition = static_cast<GuardCondition *>(guard_condition->data);
+  info->sample_loss_.set_alarm(loss_ratio, window, [condition]() {condition->trigger();});
+  return RMW_RET_OK;
+}
+}  // namespace rmw_fastrtps_shared_cpp
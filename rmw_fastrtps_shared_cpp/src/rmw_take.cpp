@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <mutex>
+
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
 #include "rmw/serialized_message.h"
@@ -26,10 +29,56 @@
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 namespace rmw_fastrtps_shared_cpp
 {
+/// Trace a sample being taken, and keep its timestamps for the taken sample info.
+/**
+ * Its latencies are recorded too, unless it had already been taken or read before,
+ * or its reception time is not known.
+ */
+static void
+_sample_taken(
+  CustomSubscriberInfo * info,
+  const eprosima::fastrtps::SampleInfo_t & sinfo,
+  int64_t reception_time,
+  bool first_take = true)
+{
+  RMW_FASTRTPS_TRACEPOINT(
+    take, &info->subscriber_->getGuid(), &sinfo.sample_identity.writer_guid(),
+    sequence_number_to_int64(sinfo.sample_identity.sequence_number()));
+  info->last_taken_.source_timestamp_ns = time_to_nanoseconds(sinfo.sourceTimestamp);
+  info->last_taken_.reception_timestamp_ns = reception_time;
+  info->last_taken_.sequence_number =
+    sequence_number_to_int64(sinfo.sample_identity.sequence_number());
+  if (first_take && reception_time != 0) {
+    info->transport_latency_.record(reception_time - time_to_nanoseconds(sinfo.sourceTimestamp));
+    info->queueing_latency_.record(current_time_nanoseconds() - reception_time);
+  }
+}
+
+/// Account for a sample removed from the history, before any take filter is applied.
+static void
+_sample_received(
+  CustomSubscriberInfo * info,
+  const eprosima::fastrtps::SampleInfo_t & sinfo,
+  const SerializedData & data,
+  int64_t reception_time)
+{
+  RMW_FASTRTPS_TRACEPOINT(
+    sample_received, &info->subscriber_->getGuid(), &sinfo.sample_identity.writer_guid(),
+    sequence_number_to_int64(sinfo.sample_identity.sequence_number()), reception_time);
+  info->sample_loss_.sample_received(
+    sinfo.sample_identity.writer_guid(), sinfo.sample_identity.sequence_number());
+  if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
+    info->rate_.record(
+      reception_time != 0 ? reception_time : current_time_nanoseconds(), data.cdr_length);
+  }
+}
+
 void
 _assign_message_info(
   const char * identifier,
@@ -43,6 +92,114 @@ _assign_message_info(
     sizeof(eprosima::fastrtps::rtps::GUID_t));
 }
 
+static bool
+_has_take_filter(const CustomSubscriberInfo * info)
+{
+  return info->minimum_separation_ns_ > 0 || info->max_sample_age_ns_ > 0 ||
+         std::atomic_load(&info->content_filter_);
+}
+
+/// Return whether an alive serialized sample must be discarded instead of being taken.
+static bool
+_is_sample_filtered(
+  CustomSubscriberInfo * info,
+  const eprosima::fastrtps::SampleInfo_t & sinfo,
+  eprosima::fastcdr::FastBuffer & buffer)
+{
+  if (
+    info->max_sample_age_ns_ > 0 &&
+    current_time_nanoseconds() - time_to_nanoseconds(sinfo.sourceTimestamp) >
+    info->max_sample_age_ns_)
+  {
+    ++info->expired_sample_count_;
+    return true;
+  }
+  auto content_filter = std::atomic_load(&info->content_filter_);
+  if (content_filter && !(*content_filter)(buffer)) {
+    return true;
+  }
+  if (info->minimum_separation_ns_ > 0) {
+    int64_t timestamp = time_to_nanoseconds(sinfo.sourceTimestamp);
+    int64_t separation = timestamp - info->last_taken_timestamp_ns_;
+    if (
+      info->last_taken_timestamp_ns_ != 0 &&
+      separation < info->minimum_separation_ns_ && -separation < info->minimum_separation_ns_)
+    {
+      return true;
+    }
+    info->last_taken_timestamp_ns_ = timestamp;
+  }
+  return false;
+}
+
+/// Take or read the latest sample from the mailbox of a subscription.
+/**
+ * The sample is either deserialized into `ros_message`, or copied into
+ * `serialized_message` when `ros_message` is null.
+ * A sample which is only read stays in the mailbox until it is taken or overwritten.
+ */
+static rmw_ret_t
+_take_from_mailbox(
+  const char * identifier,
+  CustomSubscriberInfo * info,
+  void * ros_message,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info,
+  bool remove)
+{
+  SubscriberMailbox * mailbox = info->mailbox_.get();
+  std::lock_guard<std::mutex> lock(mailbox->mutex_);
+  if (!mailbox->full_) {
+    info->counters_.take_missed();
+    return RMW_RET_OK;
+  }
+
+  bool first_take = mailbox->unread_;
+  if (mailbox->unread_) {
+    mailbox->unread_ = false;
+    info->listener_->data_taken();
+    // the filters are applied once, when the sample is first taken or read
+    if (_has_take_filter(info) && _is_sample_filtered(info, mailbox->sinfo_, mailbox->buffer_)) {
+      mailbox->full_ = false;
+      info->counters_.take_missed();
+      return RMW_RET_OK;
+    }
+  }
+
+  if (ros_message) {
+    auto start = info->counters_.conversion_start();
+    eprosima::fastcdr::Cdr deser(
+      mailbox->buffer_, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+    if (!info->type_support_->deserializeROSmessage(deser, ros_message)) {
+      RMW_SET_ERROR_MSG("cannot deserialize data");
+      return RMW_RET_ERROR;
+    }
+    info->counters_.message_taken(mailbox->length_, info->counters_.conversion_time_ns(start));
+  } else {
+    if (serialized_message->buffer_capacity < mailbox->length_) {
+      auto ret = rmw_serialized_message_resize(serialized_message, mailbox->length_);
+      if (ret != RMW_RET_OK) {
+        return ret;  // Error message already set
+      }
+    }
+    serialized_message->buffer_length = mailbox->length_;
+    memcpy(serialized_message->buffer, mailbox->buffer_.getBuffer(), mailbox->length_);
+    info->counters_.message_taken(mailbox->length_, 0);
+  }
+
+  if (message_info) {
+    _assign_message_info(identifier, message_info, &mailbox->sinfo_);
+  }
+  if (remove) {
+    mailbox->full_ = false;
+  }
+  _sample_taken(info, mailbox->sinfo_, mailbox->reception_time_ns_, first_take);
+  *taken = true;
+
+  return RMW_RET_OK;
+}
+
 rmw_ret_t
 _take(
   const char * identifier,
@@ -61,20 +218,74 @@ _take(
   CustomSubscriberInfo * info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
+  if (info->mailbox_) {
+    return _take_from_mailbox(
+      identifier, info, ros_message, nullptr, taken, message_info, true);
+  }
+
   eprosima::fastrtps::SampleInfo_t sinfo;
 
   rmw_fastrtps_shared_cpp::SerializedData data;
-  data.is_cdr_buffer = false;
-  data.data = ros_message;
-  if (info->subscriber_->takeNextData(&data, &sinfo)) {
-    info->listener_->data_taken();
+  if (!_has_take_filter(info)) {
+    data.is_cdr_buffer = false;
+    data.data = ros_message;
+    data.time_conversion = info->counters_.times_conversions();
+    if (info->subscriber_->takeNextData(&data, &sinfo)) {
+      int64_t reception_time = info->listener_->data_taken();
+      _sample_received(info, sinfo, data, reception_time);
+
+      if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
+        if (message_info) {
+          _assign_message_info(identifier, message_info, &sinfo);
+        }
+        info->counters_.message_taken(data.cdr_length, data.conversion_time_ns);
+        _sample_taken(info, sinfo, reception_time);
+        *taken = true;
+      }
+    }
+    if (!*taken) {
+      info->counters_.take_missed();
+    }
+
+    return RMW_RET_OK;
+  }
+
+  // Take the samples serialized, so that the discarded ones are never deserialized
+  data.is_cdr_buffer = true;
+  while (true) {
+    // a buffer can only be reserved once, unless it is overwritten in place
+    eprosima::fastcdr::FastBuffer sample_buffer;
+    eprosima::fastcdr::FastBuffer & buffer =
+      info->take_buffer_ ? *info->take_buffer_ : sample_buffer;
+    data.data = &buffer;
+    if (!info->subscriber_->takeNextData(&data, &sinfo)) {
+      break;
+    }
+    int64_t reception_time = info->listener_->data_taken();
+    _sample_received(info, sinfo, data, reception_time);
 
     if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
+      if (_is_sample_filtered(info, sinfo, buffer)) {
+        continue;
+      }
+      auto start = info->counters_.conversion_start();
+      eprosima::fastcdr::Cdr deser(
+        buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::Cdr::DDS_CDR);
+      if (!info->type_support_->deserializeROSmessage(deser, ros_message)) {
+        RMW_SET_ERROR_MSG("cannot deserialize data");
+        return RMW_RET_ERROR;
+      }
+      info->counters_.message_taken(data.cdr_length, info->counters_.conversion_time_ns(start));
       if (message_info) {
         _assign_message_info(identifier, message_info, &sinfo);
       }
+      _sample_taken(info, sinfo, reception_time);
       *taken = true;
     }
+    break;
+  }
+  if (!*taken) {
+    info->counters_.take_missed();
   }
 
   return RMW_RET_OK;
@@ -115,6 +326,38 @@ __rmw_take_with_info(
   return _take(identifier, subscription, ros_message, taken, message_info);
 }
 
+rmw_ret_t
+__rmw_read_latest(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    subscription, "subscription pointer is null", return RMW_RET_ERROR);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    ros_message, "ros_message pointer is null", return RMW_RET_ERROR);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(taken, "boolean flag for taken is null", return RMW_RET_ERROR);
+
+  *taken = false;
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  CustomSubscriberInfo * info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
+
+  if (!info->mailbox_) {
+    RMW_SET_ERROR_MSG("subscription is not a mailbox");
+    return RMW_RET_ERROR;
+  }
+
+  return _take_from_mailbox(identifier, info, ros_message, nullptr, taken, message_info, false);
+}
+
 rmw_ret_t
 _take_serialized_message(
   const char * identifier,
@@ -133,17 +376,32 @@ _take_serialized_message(
   CustomSubscriberInfo * info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
+  if (info->mailbox_) {
+    return _take_from_mailbox(
+      identifier, info, nullptr, serialized_message, taken, message_info, true);
+  }
+
   eprosima::fastrtps::SampleInfo_t sinfo;
 
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.is_cdr_buffer = true;
-  data.data = &buffer;
-  if (info->subscriber_->takeNextData(&data, &sinfo)) {
-    info->listener_->data_taken();
+  while (true) {
+    // a buffer can only be reserved once, unless it is overwritten in place
+    eprosima::fastcdr::FastBuffer sample_buffer;
+    eprosima::fastcdr::FastBuffer & buffer =
+      info->take_buffer_ ? *info->take_buffer_ : sample_buffer;
+    data.data = &buffer;
+    if (!info->subscriber_->takeNextData(&data, &sinfo)) {
+      break;
+    }
+    int64_t reception_time = info->listener_->data_taken();
+    _sample_received(info, sinfo, data, reception_time);
 
     if (eprosima::fastrtps::rtps::ALIVE == sinfo.sampleKind) {
-      auto buffer_size = static_cast<size_t>(buffer.getBufferSize());
+      if (_has_take_filter(info) && _is_sample_filtered(info, sinfo, buffer)) {
+        continue;
+      }
+      auto buffer_size = static_cast<size_t>(data.cdr_length);
       if (serialized_message->buffer_capacity < buffer_size) {
         auto ret = rmw_serialized_message_resize(serialized_message, buffer_size);
         if (ret != RMW_RET_OK) {
@@ -152,12 +410,18 @@ _take_serialized_message(
       }
       serialized_message->buffer_length = buffer_size;
       memcpy(serialized_message->buffer, buffer.getBuffer(), serialized_message->buffer_length);
+      info->counters_.message_taken(buffer_size, 0);
 
       if (message_info) {
         _assign_message_info(identifier, message_info, &sinfo);
       }
+      _sample_taken(info, sinfo, reception_time);
       *taken = true;
     }
+    break;
+  }
+  if (!*taken) {
+    info->counters_.take_missed();
   }
 
   return RMW_RET_OK;
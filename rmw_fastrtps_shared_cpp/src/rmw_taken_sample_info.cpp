@@ -0,0 +1,117 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+rmw_ret_t
+__rmw_get_subscription_taken_sample_info(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  TakenSampleInfo * sample_info)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (subscription->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("subscription handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!sample_info) {
+    RMW_SET_ERROR_MSG("sample info is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomSubscriberInfo *>(subscription->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("subscription info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *sample_info = info->last_taken_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_service_taken_request_info(
+  const char * identifier,
+  const rmw_service_t * service,
+  TakenSampleInfo * sample_info)
+{
+  if (!service) {
+    RMW_SET_ERROR_MSG("service is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (service->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("service handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!sample_info) {
+    RMW_SET_ERROR_MSG("sample info is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomServiceInfo *>(service->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("service info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *sample_info = info->last_taken_;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_get_client_taken_response_info(
+  const char * identifier,
+  const rmw_client_t * client,
+  TakenSampleInfo * sample_info)
+{
+  if (!client) {
+    RMW_SET_ERROR_MSG("client is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (client->implementation_identifier != identifier) {
+    RMW_SET_ERROR_MSG("client handle not from this implementation");
+    return RMW_RET_ERROR;
+  }
+
+  if (!sample_info) {
+    RMW_SET_ERROR_MSG("sample info is null");
+    return RMW_RET_ERROR;
+  }
+
+  auto info = static_cast<const CustomClientInfo *>(client->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("client info handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  *sample_info = info->last_taken_;
+  return RMW_RET_OK;
+}
+}  // namespace rmw_fastrtps_shared_cpp
@@ -21,6 +21,8 @@
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/tracepoints.hpp"
 #include "types/custom_wait_set_info.hpp"
 #include "types/guard_condition.hpp"
 
@@ -105,6 +107,8 @@ __rmw_wait(
     RMW_SET_ERROR_MSG("Condition variable for wait set was null");
     return RMW_RET_ERROR;
   }
+  auto start = std::chrono::steady_clock::now();
+  uint64_t blocked_time_ns = 0;
 
   if (subscriptions) {
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
@@ -150,17 +154,29 @@ __rmw_wait(
     };
 
   bool timeout = false;
+  bool blocked = false;
   if (!hasData) {
+    auto block_start = std::chrono::steady_clock::now();
+    RMW_FASTRTPS_TRACEPOINT(
+      wait_block, wait_set,
+      wait_timeout ?
+      static_cast<int64_t>(wait_timeout->sec * 1000000000ull + wait_timeout->nsec) : -1ll);
     if (!wait_timeout) {
+      blocked = true;
       conditionVariable->wait(lock, predicate);
     } else if (wait_timeout->sec > 0 || wait_timeout->nsec > 0) {
       auto n = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::seconds(wait_timeout->sec));
       n += std::chrono::nanoseconds(wait_timeout->nsec);
+      blocked = true;
       timeout = !conditionVariable->wait_for(lock, n, predicate);
     } else {
       timeout = true;
     }
+    if (blocked) {
+      blocked_time_ns = elapsed_nanoseconds(block_start);
+    }
+    RMW_FASTRTPS_TRACEPOINT(wait_wake, wait_set, timeout ? 1 : 0);
   }
 
   // Unlock the condition variable mutex to prevent deadlocks that can occur if
@@ -170,6 +186,9 @@ __rmw_wait(
   // after we check, it will be caught on the next call to this function).
   lock.unlock();
 
+  size_t attached_count = 0;
+  size_t ready_count = 0;
+
   if (subscriptions) {
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
       void * data = subscriptions->subscribers[i];
@@ -177,8 +196,11 @@ __rmw_wait(
       custom_subscriber_info->listener_->detachCondition();
       if (!custom_subscriber_info->listener_->hasData()) {
         subscriptions->subscribers[i] = 0;
+      } else {
+        ++ready_count;
       }
     }
+    attached_count += subscriptions->subscriber_count;
   }
 
   if (clients) {
@@ -188,8 +210,11 @@ __rmw_wait(
       custom_client_info->listener_->detachCondition();
       if (!custom_client_info->listener_->hasData()) {
         clients->clients[i] = 0;
+      } else {
+        ++ready_count;
       }
     }
+    attached_count += clients->client_count;
   }
 
   if (services) {
@@ -199,8 +224,11 @@ __rmw_wait(
       custom_service_info->listener_->detachCondition();
       if (!custom_service_info->listener_->hasData()) {
         services->services[i] = 0;
+      } else {
+        ++ready_count;
       }
     }
+    attached_count += services->service_count;
   }
 
   if (guard_conditions) {
@@ -210,10 +238,18 @@ __rmw_wait(
       guard_condition->detachCondition();
       if (!guard_condition->getHasTriggered()) {
         guard_conditions->guard_conditions[i] = 0;
+      } else {
+        ++ready_count;
       }
     }
+    attached_count += guard_conditions->guard_condition_count;
   }
 
+  uint64_t call_time_ns = elapsed_nanoseconds(start);
+  wait_set_info->counters.wait_done(
+    attached_count, ready_count, blocked, timeout, blocked_time_ns,
+    call_time_ns - blocked_time_ns);
+
   return timeout ? RMW_RET_TIMEOUT : RMW_RET_OK;
 }
 }  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,313 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/statistics_export.hpp"
+#include "rmw_fastrtps_shared_cpp/time_utils.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+static void
+_copy_name(char * destination, size_t size, const std::string & name)
+{
+  size_t length = std::min(name.size(), size - 1);
+  memcpy(destination, name.data(), length);
+  destination[length] = '\0';
+}
+
+std::shared_ptr<StatisticsExporter>
+StatisticsExporter::get_instance(
+  const std::string & directory, int64_t period_ns, size_t record_capacity)
+{
+  static std::mutex instance_mutex;
+  static std::weak_ptr<StatisticsExporter> instance;
+
+  std::lock_guard<std::mutex> lock(instance_mutex);
+  auto exporter = instance.lock();
+  if (exporter) {
+    return exporter;
+  }
+
+#ifndef _WIN32
+  std::string path =
+    directory + "/rmw_fastrtps_" + std::to_string(static_cast<uint64_t>(getpid())) + ".stats";
+  size_t size = sizeof(StatisticsExportHeader) + record_capacity * sizeof(StatisticsExportRecord);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp", "cannot create statistics file '%s'", path.c_str());
+    return nullptr;
+  }
+  void * mapping = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (MAP_FAILED == mapping) {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp", "cannot map statistics file '%s'", path.c_str());
+    unlink(path.c_str());
+    return nullptr;
+  }
+
+  exporter.reset(new StatisticsExporter(path, mapping, size, period_ns, record_capacity));
+  instance = exporter;
+  return exporter;
+#else
+  (void)directory;
+  (void)period_ns;
+  (void)record_capacity;
+  RCUTILS_LOG_WARN_NAMED(
+    "rmw_fastrtps_shared_cpp", "statistics export is not supported on this platform");
+  return nullptr;
+#endif
+}
+
+StatisticsExporter::StatisticsExporter(
+  const std::string & path, void * mapping, size_t size, int64_t period_ns,
+  size_t record_capacity)
+: path_(path), mapping_(mapping), size_(size),
+  header_(static_cast<StatisticsExportHeader *>(mapping)), period_ns_(period_ns), stop_(false)
+{
+  // the file is zero filled, so every record starts free with an even sequence
+  header_->version = statistics_export_version;
+  header_->header_size = sizeof(StatisticsExportHeader);
+  header_->record_size = sizeof(StatisticsExportRecord);
+  header_->record_capacity = static_cast<uint32_t>(record_capacity);
+#ifndef _WIN32
+  header_->pid = static_cast<uint64_t>(getpid());
+#endif
+  header_->period_ns = period_ns;
+  // the magic is written last, so that a valid magic means a complete header
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(header_->magic, statistics_export_magic, sizeof(header_->magic));
+
+  free_indexes_.reserve(record_capacity);
+  for (size_t i = record_capacity; i > 0; --i) {
+    free_indexes_.push_back(i - 1);
+  }
+  thread_ = std::thread(&StatisticsExporter::run, this);
+}
+
+StatisticsExporter::~StatisticsExporter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_condition_.notify_one();
+  thread_.join();
+#ifndef _WIN32
+  munmap(mapping_, size_);
+  unlink(path_.c_str());
+#endif
+}
+
+StatisticsExportRecord *
+StatisticsExporter::record(size_t index)
+{
+  auto records = reinterpret_cast<StatisticsExportRecord *>(header_ + 1);
+  return &records[index];
+}
+
+void
+StatisticsExporter::add(
+  const void * entity, StatisticsExportKind kind,
+  const std::string & node_name, const std::string & name, Fill fill)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_indexes_.empty()) {
+    RCUTILS_LOG_WARN_NAMED(
+      "rmw_fastrtps_shared_cpp",
+      "statistics file is full, not exporting '%s'", name.c_str());
+    return;
+  }
+  size_t index = free_indexes_.back();
+  free_indexes_.pop_back();
+
+  StatisticsExportRecord * exported = record(index);
+  exported->sequence.fetch_add(1, std::memory_order_acq_rel);
+  memset(
+    reinterpret_cast<char *>(exported) + sizeof(exported->sequence), 0,
+    sizeof(StatisticsExportRecord) - sizeof(exported->sequence));
+  exported->kind = kind;
+  _copy_name(exported->node_name, sizeof(exported->node_name), node_name);
+  _copy_name(exported->name, sizeof(exported->name), name);
+  exported->sequence.fetch_add(1, std::memory_order_release);
+
+  entries_[entity] = Entry{index, std::move(fill)};
+}
+
+void
+StatisticsExporter::remove(const void * entity)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(entity);
+  if (it == entries_.end()) {
+    return;
+  }
+  StatisticsExportRecord * exported = record(it->second.index);
+  exported->sequence.fetch_add(1, std::memory_order_acq_rel);
+  exported->kind = STATISTICS_EXPORT_FREE;
+  exported->sequence.fetch_add(1, std::memory_order_release);
+
+  free_indexes_.push_back(it->second.index);
+  entries_.erase(it);
+}
+
+void
+StatisticsExporter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_condition_.wait_for(
+      lock, std::chrono::nanoseconds(period_ns_), [this]() {return stop_;}))
+  {
+    for (auto & entry : entries_) {
+      StatisticsExportRecord * exported = record(entry.second.index);
+      exported->sequence.fetch_add(1, std::memory_order_acq_rel);
+      memset(&exported->statistics, 0, sizeof(exported->statistics));
+      entry.second.fill(*exported);
+      exported->sequence.fetch_add(1, std::memory_order_release);
+    }
+    header_->last_update_ns.store(current_time_nanoseconds(), std::memory_order_relaxed);
+    header_->update_count.fetch_add(1, std::memory_order_release);
+  }
+}
+
+static std::string
+_node_name(const rmw_node_t * node)
+{
+  std::string node_namespace = node->namespace_;
+  if (node_namespace.empty() || node_namespace.back() != '/') {
+    node_namespace += '/';
+  }
+  return node_namespace + node->name;
+}
+
+void
+export_node_statistics(const rmw_node_t * node)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (!impl->statistics_exporter) {
+    return;
+  }
+  ::ParticipantListener * listener = impl->listener;
+  impl->statistics_exporter->add(
+    impl, STATISTICS_EXPORT_NODE, _node_name(node), "",
+    [impl, listener](StatisticsExportRecord & exported) {
+      impl->entity_counters.add_to(exported.statistics);
+      exported.discovered_participants = listener->discovered_participant_count_.load();
+      listener->discovery_counters_.snapshot(exported.discovery);
+      {
+        std::lock_guard<std::mutex> guard(listener->reader_topic_cache.getMutex());
+        exported.discovered_reader_topics = listener->reader_topic_cache.getTopicToTypes().size();
+      }
+      {
+        std::lock_guard<std::mutex> guard(listener->writer_topic_cache.getMutex());
+        exported.discovered_writer_topics = listener->writer_topic_cache.getTopicToTypes().size();
+      }
+    });
+}
+
+void
+export_publisher_statistics(
+  const rmw_node_t * node, const CustomPublisherInfo * info, const char * topic_name)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (!impl->statistics_exporter) {
+    return;
+  }
+  impl->statistics_exporter->add(
+    info, STATISTICS_EXPORT_PUBLISHER, _node_name(node), topic_name,
+    [info](StatisticsExportRecord & exported) {
+      info->counters_.add_to(exported.statistics);
+    });
+}
+
+void
+export_subscription_statistics(
+  const rmw_node_t * node, const CustomSubscriberInfo * info, const char * topic_name)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (!impl->statistics_exporter) {
+    return;
+  }
+  impl->statistics_exporter->add(
+    info, STATISTICS_EXPORT_SUBSCRIPTION, _node_name(node), topic_name,
+    [info](StatisticsExportRecord & exported) {
+      info->counters_.add_to(exported.statistics);
+      info->transport_latency_.snapshot(exported.transport_latency);
+      info->queueing_latency_.snapshot(exported.queueing_latency);
+    });
+}
+
+void
+export_service_statistics(
+  const rmw_node_t * node, const CustomServiceInfo * info, const char * service_name)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (!impl->statistics_exporter) {
+    return;
+  }
+  impl->statistics_exporter->add(
+    info, STATISTICS_EXPORT_SERVICE, _node_name(node), service_name,
+    [info](StatisticsExportRecord & exported) {
+      info->counters_.add_to(exported.statistics);
+    });
+}
+
+void
+export_client_statistics(
+  const rmw_node_t * node, const CustomClientInfo * info, const char * service_name)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (!impl->statistics_exporter) {
+    return;
+  }
+  impl->statistics_exporter->add(
+    info, STATISTICS_EXPORT_CLIENT, _node_name(node), service_name,
+    [info](StatisticsExportRecord & exported) {
+      info->counters_.add_to(exported.statistics);
+      info->round_trip_.snapshot(exported.round_trip_latency);
+    });
+}
+
+void
+unexport_statistics(const rmw_node_t * node, const void * entity)
+{
+  auto impl = static_cast<CustomParticipantInfo *>(node->data);
+  if (impl && impl->statistics_exporter) {
+    impl->statistics_exporter->remove(entity);
+  }
+}
+}  // namespace rmw_fastrtps_shared_cpp
@@ -18,10 +18,13 @@
 #include <condition_variable>
 #include <mutex>
 
+#include "rmw_fastrtps_shared_cpp/wait_set_counters.hpp"
+
 typedef struct CustomWaitsetInfo
 {
   std::condition_variable condition;
   std::mutex condition_mutex;
+  rmw_fastrtps_shared_cpp::WaitSetCounters counters;
 } CustomWaitsetInfo;
 
 #endif  // TYPES__CUSTOM_WAIT_SET_INFO_HPP_
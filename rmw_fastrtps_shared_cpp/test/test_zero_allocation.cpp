@@ -0,0 +1,289 @@
+// Copyright 2018 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Once RMW_FASTRTPS_ZERO_ALLOCATION is set, publishing, waiting, taking, and sending and
+// taking requests and responses must not allocate in steady state. The allocations made by
+// the calling thread are counted by interposing the allocation functions of glibc, while
+// the threads of Fast RTPS are not accounted for.
+//
+// Each rmw implementation builds this test against its own library, from the source
+// installed by rmw_fastrtps_shared_cpp.
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/qos_profiles.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_cpp/service_type_support.hpp"
+#include "test_msgs/msg/primitives.hpp"
+#include "test_msgs/srv/empty.hpp"
+
+namespace
+{
+thread_local bool counting = false;
+thread_local size_t allocations = 0;
+
+// Number of round trips after which the buffers and histories have reached their size
+constexpr size_t warm_up_iterations = 100;
+constexpr size_t measured_iterations = 1000;
+}  // namespace
+
+extern "C"
+{
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * pointer, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+
+void *
+malloc(size_t size)
+{
+  allocations += counting ? 1 : 0;
+  return __libc_malloc(size);
+}
+
+void *
+calloc(size_t count, size_t size)
+{
+  allocations += counting ? 1 : 0;
+  return __libc_calloc(count, size);
+}
+
+void *
+realloc(void * pointer, size_t size)
+{
+  allocations += counting ? 1 : 0;
+  return __libc_realloc(pointer, size);
+}
+
+void *
+memalign(size_t alignment, size_t size)
+{
+  allocations += counting ? 1 : 0;
+  return __libc_memalign(alignment, size);
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size)
+{
+  allocations += counting ? 1 : 0;
+  return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void ** pointer, size_t alignment, size_t size)
+{
+  if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || 0 == alignment) {
+    return EINVAL;
+  }
+  allocations += counting ? 1 : 0;
+  void * allocated = __libc_memalign(alignment, size);
+  if (!allocated && size != 0) {
+    return ENOMEM;
+  }
+  *pointer = allocated;
+  return 0;
+}
+}  // extern "C"
+
+class TestZeroAllocation : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // read when the node is created
+    ASSERT_EQ(0, setenv("RMW_FASTRTPS_ZERO_ALLOCATION", "1", 1));
+    init_options_ = rmw_get_zero_initialized_init_options();
+    ASSERT_EQ(RMW_RET_OK, rmw_init_options_init(&init_options_, rcutils_get_default_allocator()));
+    context_ = rmw_get_zero_initialized_context();
+    ASSERT_EQ(RMW_RET_OK, rmw_init(&init_options_, &context_));
+    rmw_node_security_options_t security_options = rmw_get_default_node_security_options();
+    node_ = rmw_create_node(&context_, "test_zero_allocation", "/", 0, &security_options);
+    ASSERT_NE(nullptr, node_) << rmw_get_error_string().str;
+    wait_set_ = rmw_create_wait_set(&context_, 1);
+    ASSERT_NE(nullptr, wait_set_) << rmw_get_error_string().str;
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_destroy_wait_set(wait_set_));
+    EXPECT_EQ(RMW_RET_OK, rmw_destroy_node(node_));
+    EXPECT_EQ(RMW_RET_OK, rmw_shutdown(&context_));
+    EXPECT_EQ(RMW_RET_OK, rmw_context_fini(&context_));
+    EXPECT_EQ(RMW_RET_OK, rmw_init_options_fini(&init_options_));
+  }
+
+  /// Call the function, and return the number of allocations it made.
+  static size_t
+  count_allocations(const std::function<rmw_ret_t()> & function)
+  {
+    size_t before = allocations;
+    counting = true;
+    rmw_ret_t ret = function();
+    counting = false;
+    EXPECT_EQ(RMW_RET_OK, ret);
+    return allocations - before;
+  }
+
+  /// Wait for the subscription, service or client to have something to take, and return
+  /// the number of allocations rmw_wait made.
+  size_t
+  wait_for(
+    rmw_subscription_t * subscription, rmw_service_t * service, rmw_client_t * client)
+  {
+    void * subscription_handles[] = {subscription ? subscription->data : nullptr};
+    void * service_handles[] = {service ? service->data : nullptr};
+    void * client_handles[] = {client ? client->data : nullptr};
+    rmw_subscriptions_t subscriptions = {subscription ? 1u : 0u, subscription_handles};
+    rmw_services_t services = {service ? 1u : 0u, service_handles};
+    rmw_clients_t clients = {client ? 1u : 0u, client_handles};
+    rmw_time_t timeout = {10, 0};
+    return count_allocations([&]() {
+        return rmw_wait(&subscriptions, nullptr, &services, &clients, wait_set_, &timeout);
+      });
+  }
+
+  rmw_init_options_t init_options_;
+  rmw_context_t context_;
+  rmw_node_t * node_;
+  rmw_wait_set_t * wait_set_;
+};
+
+TEST_F(TestZeroAllocation, publish_and_take) {
+  auto type_support =
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Primitives>();
+  rmw_qos_profile_t qos = rmw_qos_profile_default;
+  qos.depth = 10;
+  rmw_publisher_t * publisher = rmw_create_publisher(
+    node_, type_support, "/test_zero_allocation", &qos);
+  ASSERT_NE(nullptr, publisher) << rmw_get_error_string().str;
+  rmw_subscription_t * subscription = rmw_create_subscription(
+    node_, type_support, "/test_zero_allocation", &qos, false);
+  ASSERT_NE(nullptr, subscription) << rmw_get_error_string().str;
+  size_t matched = 0;
+  for (int i = 0; i < 1000 && matched == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(subscription, &matched));
+  }
+  ASSERT_EQ(1u, matched);
+
+  // short enough for the string not to allocate
+  test_msgs::msg::Primitives message;
+  message.int32_value = 42;
+  message.string_value = "zero";
+  test_msgs::msg::Primitives taken_message;
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message, 1024, &allocator));
+
+  size_t publish_allocations = 0;
+  size_t wait_allocations = 0;
+  size_t take_allocations = 0;
+  for (size_t i = 0; i < warm_up_iterations + measured_iterations; ++i) {
+    if (i == warm_up_iterations) {
+      publish_allocations = 0;
+      wait_allocations = 0;
+      take_allocations = 0;
+    }
+    bool serialized = i % 2 == 1;
+    bool taken = false;
+    publish_allocations += count_allocations([&]() {
+        return rmw_publish(publisher, &message);
+      });
+    wait_allocations += wait_for(subscription, nullptr, nullptr);
+    take_allocations += count_allocations([&]() {
+        return serialized ?
+        rmw_take_serialized_message(subscription, &serialized_message, &taken) :
+        rmw_take(subscription, &taken_message, &taken);
+      });
+    ASSERT_TRUE(taken);
+  }
+  EXPECT_EQ(0u, publish_allocations);
+  EXPECT_EQ(0u, wait_allocations);
+  EXPECT_EQ(0u, take_allocations);
+
+  EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message));
+  EXPECT_EQ(RMW_RET_OK, rmw_destroy_subscription(node_, subscription));
+  EXPECT_EQ(RMW_RET_OK, rmw_destroy_publisher(node_, publisher));
+}
+
+TEST_F(TestZeroAllocation, request_and_response) {
+  auto type_support =
+    rosidl_typesupport_cpp::get_service_type_support_handle<test_msgs::srv::Empty>();
+  rmw_qos_profile_t qos = rmw_qos_profile_services_default;
+  rmw_service_t * service = rmw_create_service(
+    node_, type_support, "/test_zero_allocation", &qos);
+  ASSERT_NE(nullptr, service) << rmw_get_error_string().str;
+  rmw_client_t * client = rmw_create_client(node_, type_support, "/test_zero_allocation", &qos);
+  ASSERT_NE(nullptr, client) << rmw_get_error_string().str;
+  bool available = false;
+  for (int i = 0; i < 1000 && !available; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(RMW_RET_OK, rmw_service_server_is_available(node_, client, &available));
+  }
+  ASSERT_TRUE(available);
+
+  test_msgs::srv::Empty::Request request;
+  test_msgs::srv::Empty::Response response;
+  size_t client_allocations = 0;
+  size_t service_allocations = 0;
+  size_t wait_allocations = 0;
+  for (size_t i = 0; i < warm_up_iterations + measured_iterations; ++i) {
+    if (i == warm_up_iterations) {
+      client_allocations = 0;
+      service_allocations = 0;
+      wait_allocations = 0;
+    }
+    int64_t sequence_id = 0;
+    rmw_request_id_t header;
+    bool taken = false;
+    client_allocations += count_allocations([&]() {
+        return rmw_send_request(client, &request, &sequence_id);
+      });
+    wait_allocations += wait_for(nullptr, service, nullptr);
+    service_allocations += count_allocations([&]() {
+        return rmw_take_request(service, &header, &request, &taken);
+      });
+    ASSERT_TRUE(taken);
+    service_allocations += count_allocations([&]() {
+        return rmw_send_response(service, &header, &response);
+      });
+    wait_allocations += wait_for(nullptr, nullptr, client);
+    taken = false;
+    client_allocations += count_allocations([&]() {
+        return rmw_take_response(client, &header, &response, &taken);
+      });
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(sequence_id, header.sequence_number);
+  }
+  EXPECT_EQ(0u, client_allocations);
+  EXPECT_EQ(0u, service_allocations);
+  EXPECT_EQ(0u, wait_allocations);
+
+  EXPECT_EQ(RMW_RET_OK, rmw_destroy_client(node_, client));
+  EXPECT_EQ(RMW_RET_OK, rmw_destroy_service(node_, service));
+}